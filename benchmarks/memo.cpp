@@ -0,0 +1,93 @@
+// See LICENSE for the Copyright Notice
+
+// The sine and cosine of headings with few and with many distinct values, evaluated directly and with the
+// per-thread memoization cache of trigonometry_memo.h.
+//
+// Usage: memo [count]
+
+#include <trigonometry_memo.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+
+using namespace pg::math;
+
+using clock_type = std::chrono::steady_clock;
+
+// Headings of a sensor with a resolution of 360 / distinct degrees, or continuous headings when distinct is 0
+std::vector< deg > headings( std::size_t count, std::uint64_t distinct )
+{
+    std::vector< deg > angles( count );
+    std::uint64_t state = 42;
+    for( auto & a : angles )
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        const auto unit = static_cast< double >( state >> 11 ) / 9007199254740992.0;
+        a = distinct ? deg( static_cast< double >( static_cast< std::uint64_t >( unit * distinct ) ) * ( 360.0 / distinct ) ) : deg( unit * 360.0 );
+    }
+    return angles;
+}
+
+template< typename F >
+double nanoseconds( std::size_t count, F f )
+{
+    const auto start = clock_type::now();
+    f();
+    return std::chrono::duration< double, std::nano >( clock_type::now() - start ).count() / static_cast< double >( count );
+}
+
+template< typename P >
+void compare( const char * policy, const std::vector< deg > & input, const char * name )
+{
+    double direct_sum = 0.0;
+    const auto direct = nanoseconds( input.size(), [ & ]()
+    {
+        for( const auto & a : input )
+        {
+            direct_sum += static_cast< double >( pg::math::sin< P >( a ) ) + static_cast< double >( pg::math::cos< P >( a ) );
+        }
+    } );
+
+    double cached_sum = 0.0;
+    clear_sincos_cache< deg, P >();
+    const auto cached = nanoseconds( input.size(), [ & ]()
+    {
+        for( const auto & a : input )
+        {
+            double s;
+            double c;
+            cached_sincos< P >( a, s, c );
+            cached_sum += s + c;
+        }
+    } );
+
+    const auto stats = sincos_cache_stats< deg, P >();
+    std::printf( "%-8s %-12s direct %6.1f ns   cached %6.1f ns   hits %5.1f %%%s\n", policy, name, direct, cached,
+                 100.0 * static_cast< double >( stats.hits ) / static_cast< double >( stats.hits + stats.misses ),
+                 direct_sum == cached_sum ? "" : "   MISMATCH" );
+}
+
+}
+
+int main( const int argc, const char ** argv )
+{
+    const auto count = argc > 1 ? static_cast< std::size_t >( std::strtoul( argv[ 1 ], nullptr, 10 ) ) : std::size_t( 10000000 );
+
+    std::printf( "%zu headings, %zu cache entries\n", count, detail::memo::entries );
+    const std::uint64_t distinct[] = { 360, 3600, 36000, 0 };
+    const char *        names[]    = { "1 degree", "0.1 degree", "0.01 degree", "continuous" };
+    for( std::size_t i = 0 ; i < 4 ; ++i )
+    {
+        const auto input = headings( count, distinct[ i ] );
+        compare< precise >( "precise", input, names[ i ] );
+        compare< fast >( "fast", input, names[ i ] );
+    }
+
+    return 0;
+}
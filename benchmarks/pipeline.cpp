@@ -0,0 +1,238 @@
+// See LICENSE for the Copyright Notice
+
+// Latency and throughput of a pipeline of sampled angles: a producer thread, a normalize stage,
+// a sincos stage and a consumer, each on its own thread. The same work is also done with mutex
+// protected queues and scalar calls for comparison.
+//
+// Usage: pipeline [blocks]
+
+#include <trigonometry_pipeline.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using namespace pg::math;
+
+using clock_type  = std::chrono::steady_clock;
+using angle_block = block< deg >;
+using result      = std::pair< double, double >;
+
+deg sample( std::size_t i ) noexcept
+{
+    return deg( static_cast< double >( i % 100000 ) * 0.7 - 30000.0 );
+}
+
+struct report
+{
+    double seconds;
+    double checksum;
+    std::vector< double > latencies; // Microseconds per block from production to consumption
+};
+
+void print( const char * name, std::size_t samples, report & r )
+{
+    std::sort( r.latencies.begin(), r.latencies.end() );
+    const auto at = [ & ]( double q ) { return r.latencies[ static_cast< std::size_t >( q * static_cast< double >( r.latencies.size() - 1 ) ) ]; };
+
+    std::printf( "%-22s %8.2f Msamples/s   latency us p50 %8.1f  p99 %8.1f  max %8.1f   (checksum %.6f)\n",
+                 name, static_cast< double >( samples ) / r.seconds * 1e-6, at( 0.5 ), at( 0.99 ), r.latencies.back(), r.checksum );
+}
+
+report run_pipeline( std::size_t blocks )
+{
+    std::unique_ptr< spsc_ring< angle_block, 16 > >         samples( new spsc_ring< angle_block, 16 >() );
+    std::unique_ptr< spsc_ring< angle_block, 16 > >         normalized( new spsc_ring< angle_block, 16 >() );
+    std::unique_ptr< spsc_ring< sincos_block<>, 16 > >      results( new spsc_ring< sincos_block<>, 16 >() );
+    std::vector< clock_type::time_point >                   produced( blocks );
+
+    report r = { 0.0, 0.0, {} };
+    r.latencies.reserve( blocks );
+
+    const auto start = clock_type::now();
+    std::thread producer( [ & ]()
+    {
+        for( std::size_t b = 0 ; b <= blocks ; ++b )
+        {
+            angle_block * out;
+            while( !( out = samples->acquire() ) )
+            {
+                std::this_thread::yield();
+            }
+
+            out->count    = b < blocks ? angle_block::capacity : 0;
+            out->sequence = b;
+            for( std::size_t i = 0 ; i < out->count ; ++i )
+            {
+                out->values[ i ] = sample( b * angle_block::capacity + i );
+            }
+            if( b < blocks )
+            {
+                produced[ b ] = clock_type::now();
+            }
+            samples->commit();
+        }
+    } );
+
+    normalize_stage      normalize;
+    sincos_stage< fast > sincos;
+    std::thread normalizer( [ & ]() { run_stage( normalize, *samples, *normalized ); } );
+    std::thread evaluator( [ & ]() { run_stage( sincos, *normalized, *results ); } );
+
+    for( ;; )
+    {
+        const sincos_block<> * in;
+        while( !( in = results->front() ) )
+        {
+            std::this_thread::yield();
+        }
+
+        if( !in->count )
+        {
+            results->pop();
+            break;
+        }
+
+        for( std::size_t i = 0 ; i < in->count ; ++i )
+        {
+            r.checksum += in->sin[ i ] + in->cos[ i ];
+        }
+        r.latencies.push_back( std::chrono::duration< double, std::micro >( clock_type::now() - produced[ in->sequence ] ).count() );
+        results->pop();
+    }
+    r.seconds = std::chrono::duration< double >( clock_type::now() - start ).count();
+
+    producer.join();
+    normalizer.join();
+    evaluator.join();
+
+    return r;
+}
+
+// A queue with a mutex and a condition variable, as used before the pipeline
+template< typename T >
+class mutex_queue
+{
+public:
+
+    void push( T value )
+    {
+        {
+            std::lock_guard< std::mutex > lock( mutex );
+            values.push_back( value );
+        }
+        ready.notify_one();
+    }
+
+    T pop()
+    {
+        std::unique_lock< std::mutex > lock( mutex );
+        ready.wait( lock, [ this ]() { return !values.empty(); } );
+        const auto value = values.front();
+        values.pop_front();
+        return value;
+    }
+
+private:
+
+    std::mutex              mutex;
+    std::condition_variable ready;
+    std::deque< T >         values;
+};
+
+report run_mutex_queues( std::size_t blocks )
+{
+    using item = std::pair< std::size_t, deg >;
+
+    mutex_queue< item >                                     samples;
+    mutex_queue< item >                                     normalized;
+    mutex_queue< std::pair< std::size_t, result > >         results;
+    std::vector< clock_type::time_point >                   produced( blocks );
+    const auto                                              count = blocks * angle_block::capacity;
+    const auto                                              end   = count;
+
+    report r = { 0.0, 0.0, {} };
+    r.latencies.reserve( blocks );
+
+    const auto start = clock_type::now();
+    std::thread producer( [ & ]()
+    {
+        for( std::size_t i = 0 ; i < count ; ++i )
+        {
+            if( i % angle_block::capacity == 0 )
+            {
+                produced[ i / angle_block::capacity ] = clock_type::now();
+            }
+            samples.push( { i, sample( i ) } );
+        }
+        samples.push( { end, deg() } );
+    } );
+
+    std::thread normalizer( [ & ]()
+    {
+        for( auto s = samples.pop() ; ; s = samples.pop() )
+        {
+            normalized.push( { s.first, s.second.normalized() } );
+            if( s.first == end )
+            {
+                return;
+            }
+        }
+    } );
+
+    std::thread evaluator( [ & ]()
+    {
+        for( auto s = normalized.pop() ; ; s = normalized.pop() )
+        {
+            results.push( { s.first, { sin< fast >( s.second ), cos< fast >( s.second ) } } );
+            if( s.first == end )
+            {
+                return;
+            }
+        }
+    } );
+
+    for( auto v = results.pop() ; v.first != end ; v = results.pop() )
+    {
+        r.checksum += v.second.first + v.second.second;
+        if( v.first % angle_block::capacity == angle_block::capacity - 1 )
+        {
+            r.latencies.push_back( std::chrono::duration< double, std::micro >( clock_type::now() - produced[ v.first / angle_block::capacity ] ).count() );
+        }
+    }
+    r.seconds = std::chrono::duration< double >( clock_type::now() - start ).count();
+
+    producer.join();
+    normalizer.join();
+    evaluator.join();
+
+    return r;
+}
+
+}
+
+int main( const int argc, const char ** argv )
+{
+    const auto blocks  = argc > 1 ? static_cast< std::size_t >( std::strtoul( argv[ 1 ], nullptr, 10 ) ) : std::size_t( 20000 );
+    const auto samples = blocks * angle_block::capacity;
+
+    std::printf( "%zu blocks of %zu samples, normalize and sincos< fast > stages\n", blocks, angle_block::capacity );
+
+    auto pipeline = run_pipeline( blocks );
+    print( "spsc ring pipeline", samples, pipeline );
+
+    auto queues = run_mutex_queues( blocks );
+    print( "mutex queues, scalar", samples, queues );
+
+    return 0;
+}
@@ -0,0 +1,285 @@
+// See LICENSE for the Copyright Notice
+
+// Performance regression gate for the functions of trigonometry.h. A fixed set of benchmarks is timed and
+// compared with a baseline file; the program fails when a function got slower than the tolerance allows.
+//
+// The timings are divided by the time of a calibration loop of integer multiply-adds that does not depend
+// on libm or the compiler's math code generation, so that a baseline taken on one machine can be used on
+// a similar machine that runs at another clock speed.
+//
+// Usage: regression <baseline file> [tolerance]   Compares with the baseline, e.g. a tolerance of 0.25 allows 25% slower
+//        regression --update <baseline file>      Writes a new baseline
+
+#include <trigonometry.h>
+#include <trigonometry_batch.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using namespace pg::math;
+
+using clock_type = std::chrono::steady_clock;
+using ideg       = basic_angle< int, deg_conv >;
+
+constexpr std::size_t count       = 4096;
+constexpr int         repetitions = 25;
+
+volatile double sink;
+
+struct benchmark
+{
+    std::string               name;
+    std::function< double() > run; // Processes count elements and returns a checksum
+};
+
+// Returns the time of one run in nanoseconds per element
+double measure( const benchmark & b )
+{
+    const auto start = clock_type::now();
+    sink = b.run();
+    return std::chrono::duration< double, std::nano >( clock_type::now() - start ).count() / count;
+}
+
+// Returns the fastest time of each benchmark; the benchmarks are run in turns after a warm up run, so that
+// changes of the clock speed and load of the machine affect the calibration as much as the other benchmarks
+std::vector< double > measure( const std::vector< benchmark > & benchmarks )
+{
+    std::vector< double > fastest( benchmarks.size() );
+    for( int r = -1 ; r < repetitions ; ++r )
+    {
+        for( std::size_t i = 0 ; i < benchmarks.size() ; ++i )
+        {
+            const auto ns = measure( benchmarks[ i ] );
+            fastest[ i ] = r <= 0 ? ns : std::min( fastest[ i ], ns );
+        }
+    }
+    return fastest;
+}
+
+// Uniformly spread values over -/+ 4 semicircles from a fixed seed
+template< typename ANGLE >
+std::vector< ANGLE > inputs()
+{
+    using conversion = typename ANGLE::conversion;
+    using value_type = typename ANGLE::value_type;
+
+    std::vector< ANGLE > angles( count );
+    std::uint64_t state = 42;
+    for( auto & a : angles )
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        const auto unit = static_cast< double >( state >> 11 ) / 9007199254740992.0 * 2.0 - 1.0;
+        a = ANGLE( static_cast< value_type >( unit * 4.0 * static_cast< double >( conversion::semicircle ) ) );
+    }
+    return angles;
+}
+
+template< typename ANGLE >
+void add_angle_benchmarks( std::vector< benchmark > & benchmarks, const std::string & type )
+{
+    const auto angles = std::make_shared< std::vector< ANGLE > >( inputs< ANGLE >() );
+    const auto results = std::make_shared< std::vector< double > >( count );
+    const auto normalized_angles = std::make_shared< std::vector< ANGLE > >( count );
+
+    benchmarks.push_back( { "sin/" + type, [ = ]()
+    {
+        auto sum = 0.0;
+        for( const auto a : *angles )
+        {
+            sum += sin( a );
+        }
+        return sum;
+    } } );
+    benchmarks.push_back( { "cos/" + type, [ = ]()
+    {
+        auto sum = 0.0;
+        for( const auto a : *angles )
+        {
+            sum += cos( a );
+        }
+        return sum;
+    } } );
+    benchmarks.push_back( { "batch_sin/" + type, [ = ]()
+    {
+        sin( angles->data(), count, results->data() );
+        return ( *results )[ count / 2 ];
+    } } );
+    benchmarks.push_back( { "batch_cos/" + type, [ = ]()
+    {
+        cos( angles->data(), count, results->data() );
+        return ( *results )[ count / 2 ];
+    } } );
+    benchmarks.push_back( { "normalize/" + type, [ = ]()
+    {
+        auto sum = 0.0;
+        for( const auto a : *angles )
+        {
+            sum += static_cast< double >( a.normalized().angle() );
+        }
+        return sum;
+    } } );
+    benchmarks.push_back( { "batch_normalize/" + type, [ = ]()
+    {
+        normalized( angles->data(), count, normalized_angles->data() );
+        return static_cast< double >( ( *normalized_angles )[ count / 2 ].angle() );
+    } } );
+}
+
+template< typename TO, typename FROM >
+void add_cast_benchmark( std::vector< benchmark > & benchmarks, const std::string & name )
+{
+    const auto angles = std::make_shared< std::vector< FROM > >( inputs< FROM >() );
+
+    benchmarks.push_back( { "angle_cast/" + name, [ = ]()
+    {
+        auto sum = 0.0;
+        for( const auto a : *angles )
+        {
+            sum += static_cast< double >( angle_cast< TO >( a ).angle() );
+        }
+        return sum;
+    } } );
+}
+
+std::vector< benchmark > make_benchmarks()
+{
+    std::vector< benchmark > benchmarks;
+
+    // Dependent chain of integer multiply-adds with a fixed latency per element
+    benchmarks.push_back( { "calibration", []()
+    {
+        std::uint64_t state = 1;
+        for( std::size_t i = 0 ; i < count * 8 ; ++i )
+        {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        }
+        return static_cast< double >( state >> 11 );
+    } } );
+
+    add_angle_benchmarks< deg >( benchmarks, "deg" );
+    add_angle_benchmarks< rad >( benchmarks, "rad" );
+    add_angle_benchmarks< grad >( benchmarks, "grad" );
+    add_angle_benchmarks< ideg >( benchmarks, "ideg" );
+
+    add_cast_benchmark< rad, deg >( benchmarks, "deg_to_rad" );
+    add_cast_benchmark< grad, rad >( benchmarks, "rad_to_grad" );
+    add_cast_benchmark< deg, grad >( benchmarks, "grad_to_deg" );
+    add_cast_benchmark< deg, ideg >( benchmarks, "ideg_to_deg" );
+    add_cast_benchmark< ideg, rad >( benchmarks, "rad_to_ideg" );
+
+    return benchmarks;
+}
+
+std::map< std::string, double > read_baseline( const char * path )
+{
+    std::map< std::string, double > baseline;
+    std::ifstream file( path );
+    std::string line;
+    while( std::getline( file, line ) )
+    {
+        if( line.empty() || line[ 0 ] == '#' )
+        {
+            continue;
+        }
+
+        std::istringstream fields( line );
+        std::string name;
+        double ns;
+        if( fields >> name >> ns )
+        {
+            baseline[ name ] = ns;
+        }
+    }
+    return baseline;
+}
+
+int update( const char * path, const std::vector< benchmark > & benchmarks )
+{
+    std::ofstream file( path );
+    if( !file )
+    {
+        std::fprintf( stderr, "Cannot write %s\n", path );
+        return 2;
+    }
+
+    const auto ns = measure( benchmarks );
+
+    file << "# Baseline of benchmarks/regression.cpp; nanoseconds per element, compared relative to the calibration loop\n";
+    for( std::size_t i = 0 ; i < benchmarks.size() ; ++i )
+    {
+        file << benchmarks[ i ].name << ' ' << ns[ i ] << '\n';
+        std::printf( "%-24s %10.3f ns\n", benchmarks[ i ].name.c_str(), ns[ i ] );
+    }
+    return 0;
+}
+
+int compare( const char * path, double tolerance, const std::vector< benchmark > & benchmarks )
+{
+    const auto baseline = read_baseline( path );
+    if( baseline.empty() || !baseline.count( "calibration" ) )
+    {
+        std::fprintf( stderr, "No calibration entry in baseline %s; create one with --update\n", path );
+        return 2;
+    }
+
+    const auto ns          = measure( benchmarks );
+    const auto calibration = ns.front();
+    const auto scale       = baseline.at( "calibration" ) / calibration; // > 1 on a faster machine
+
+    std::printf( "calibration %.3f ns, baseline %.3f ns, tolerance %.0f%%\n\n", calibration, baseline.at( "calibration" ), tolerance * 100.0 );
+    std::printf( "%-24s %12s %12s %10s  %s\n", "function", "baseline ns", "measured ns", "relative", "status" );
+
+    auto failures = 0;
+    for( std::size_t i = 1 ; i < benchmarks.size() ; ++i )
+    {
+        const auto & name  = benchmarks[ i ].name;
+        const auto   entry = baseline.find( name );
+        if( entry == baseline.end() )
+        {
+            std::printf( "%-24s %12s %12.3f %10s  new\n", name.c_str(), "-", ns[ i ], "-" );
+            continue;
+        }
+
+        const auto relative = ns[ i ] * scale / entry->second;
+        const auto failed   = relative > 1.0 + tolerance;
+        failures += failed;
+        std::printf( "%-24s %12.3f %12.3f %10.2f  %s\n", name.c_str(), entry->second, ns[ i ], relative, failed ? "SLOWER" : "ok" );
+    }
+
+    std::printf( "\n%d of %zu functions slower than the baseline\n", failures, benchmarks.size() - 1 );
+    return failures ? 1 : 0;
+}
+
+}
+
+int main( const int argc, const char ** argv )
+{
+    const auto benchmarks = make_benchmarks();
+
+    if( argc == 3 && std::strcmp( argv[ 1 ], "--update" ) == 0 )
+    {
+        return update( argv[ 2 ], benchmarks );
+    }
+    if( argc == 2 || argc == 3 )
+    {
+        return compare( argv[ 1 ], argc == 3 ? std::strtod( argv[ 2 ], nullptr ) : 0.25, benchmarks );
+    }
+
+    std::fprintf( stderr, "Usage: %s <baseline file> [tolerance]\n       %s --update <baseline file>\n", argv[ 0 ], argv[ 0 ] );
+    return 2;
+}
@@ -0,0 +1,79 @@
+// See LICENSE for the Copyright Notice
+
+// Sorting arrays of angles with std::sort and with the radix sort of trigonometry_sort.h.
+//
+// Usage: sort [count]
+
+#include <trigonometry_sort.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+
+using namespace pg::math;
+
+using clock_type = std::chrono::steady_clock;
+
+template< typename ANGLE >
+std::vector< ANGLE > bearings( std::size_t count )
+{
+    std::vector< ANGLE > angles( count );
+    std::uint64_t state = 42;
+    for( auto & a : angles )
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        const auto unit = static_cast< double >( state >> 11 ) / 9007199254740992.0;
+        a = ANGLE( static_cast< typename ANGLE::value_type >( unit * 720.0 - 360.0 ) );
+    }
+    return angles;
+}
+
+template< typename F >
+double seconds( F f )
+{
+    const auto start = clock_type::now();
+    f();
+    return std::chrono::duration< double >( clock_type::now() - start ).count();
+}
+
+template< typename ANGLE >
+void compare( const char * name, std::size_t count )
+{
+    const auto input = bearings< ANGLE >( count );
+
+    auto a = input;
+    const auto std_sort = seconds( [ & ]() { std::sort( a.begin(), a.end() ); } );
+
+    auto b = input;
+    const auto radix = seconds( [ & ]() { radix_sort( b.data(), b.size() ); } );
+
+    auto c = input;
+    const auto parallel = seconds( [ & ]() { radix_sort( c.data(), c.size(), sort_key::value, 0 ); } );
+
+    auto d = input;
+    const auto normalized = seconds( [ & ]() { radix_sort( d.data(), d.size(), sort_key::normalized, 0 ); } );
+
+    std::printf( "%-6s std::sort %8.1f ms   radix_sort %8.1f ms   parallel %8.1f ms   parallel normalized %8.1f ms%s\n",
+                 name, std_sort * 1e3, radix * 1e3, parallel * 1e3, normalized * 1e3,
+                 std::equal( a.begin(), a.end(), b.begin() ) && std::equal( a.begin(), a.end(), c.begin() ) ? "" : "   MISMATCH" );
+}
+
+}
+
+int main( const int argc, const char ** argv )
+{
+    const auto count = argc > 1 ? static_cast< std::size_t >( std::strtoul( argv[ 1 ], nullptr, 10 ) ) : std::size_t( 10000000 );
+
+    std::printf( "%zu angles\n", count );
+    compare< deg >( "deg", count );
+    compare< basic_angle< float, deg_conv > >( "float", count );
+    compare< basic_angle< int, deg_conv > >( "ideg", count );
+
+    return 0;
+}
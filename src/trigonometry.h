@@ -1,7 +1,12 @@
 // See LICENSE for the Copyright Notice
 
+#pragma once
+
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <ostream>
+#include <type_traits>
 
 #ifdef __cpp_lib_math_constants
 # include <numbers>
@@ -11,6 +16,30 @@
 # include <format>
 #endif
 
+#ifdef PG_TRIGONOMETRY_INSTRUMENTATION
+# include "trigonometry_instrumentation.h"
+# ifdef __cpp_lib_is_constant_evaluated
+#  define PG_TRIGONOMETRY_IS_CONSTANT_EVALUATED() std::is_constant_evaluated()
+# elif defined( __has_builtin )
+#  if __has_builtin( __builtin_is_constant_evaluated )
+#   define PG_TRIGONOMETRY_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#  endif
+# endif
+# define PG_TRIGONOMETRY_PROBE( function, angle ) ::pg::math::instrumentation::detail::record( ::pg::math::instrumentation::probe::function, angle )
+# ifdef PG_TRIGONOMETRY_IS_CONSTANT_EVALUATED
+// Constant evaluations of the constexpr functions are not counted
+#  define PG_TRIGONOMETRY_CONSTEXPR_PROBE( function, angle ) ( PG_TRIGONOMETRY_IS_CONSTANT_EVALUATED() ? static_cast< void >( 0 ) : \
+        PG_TRIGONOMETRY_PROBE( function, angle ) )
+# else
+// Without a way to detect constant evaluation only the calls of the functions that cannot be constant evaluated are counted
+#  define PG_TRIGONOMETRY_CONSTEXPR_PROBE( function, angle ) ::pg::math::instrumentation::detail::record_runtime( \
+        ::pg::math::instrumentation::probe::function, angle, ::pg::math::detail::normalization::is_exact< T, CONV >() )
+# endif
+#else
+# define PG_TRIGONOMETRY_PROBE( function, angle ) static_cast< void >( 0 )
+# define PG_TRIGONOMETRY_CONSTEXPR_PROBE( function, angle ) static_cast< void >( 0 )
+#endif
+
 #ifdef __has_cpp_attribute
 # if __has_cpp_attribute( nodiscard )
 #  define PG_TRIGONOMETRY_NODISCARD [[nodiscard]]
@@ -40,6 +69,96 @@ constexpr double pi = 3.141592653589793238462643383279502884L;
 
 }
 
+namespace normalization
+{
+
+template< typename CONV >
+constexpr long double full_circle() noexcept
+{
+    return CONV::semicircle * 2.0L;
+}
+
+// Integral angles are normalized with integer arithmetic when the full circle is a whole number
+template< typename T, typename CONV >
+using is_exact = std::integral_constant< bool, ( std::is_integral< T >::value &&
+                                                 full_circle< CONV >() > 0.0L && full_circle< CONV >() < 9223372036854775807.0L &&
+                                                 static_cast< long double >( static_cast< std::int64_t >( full_circle< CONV >() ) ) == full_circle< CONV >() ) >;
+
+// The narrowest signed type that holds the values of T and the full circle; 32 bits keeps batch loops vectorizable
+template< typename T, typename CONV >
+using work_t = typename std::conditional< ( sizeof( T ) < 4 || ( sizeof( T ) == 4 && std::is_signed< T >::value ) ) &&
+                                          full_circle< CONV >() <= 2147483647.0L, std::int32_t, std::int64_t >::type;
+
+// The remainder of the division by the full circle; 64 bit unsigned values are divided as unsigned values, since
+// values from 2^63 on do not fit the signed work type
+template< typename T, typename CONV >
+constexpr work_t< T, CONV > remainder( T value ) noexcept
+{
+    using division = typename std::conditional< std::is_unsigned< T >::value && sizeof( T ) >= 8, std::uint64_t, work_t< T, CONV > >::type;
+
+    return static_cast< work_t< T, CONV > >( static_cast< division >( value ) % static_cast< division >( full_circle< CONV >() ) );
+}
+
+template< typename T, typename CONV >
+constexpr T normalize( T value, std::true_type /* is_exact */ ) noexcept
+{
+    using work = work_t< T, CONV >;
+
+    // For a semicircle of x.5 the comparisons with x give the same results for whole numbers
+    constexpr auto full       = static_cast< work >( full_circle< CONV >() );
+    constexpr auto semicircle = static_cast< work >( full / 2 );
+
+    const auto remainder = normalization::remainder< T, CONV >( value );
+    return static_cast< T >( remainder < -semicircle ? remainder + full : remainder > semicircle ? remainder - full : remainder );
+}
+
+template< typename T, typename CONV >
+inline T normalize( T value, std::false_type /* is_exact */ ) noexcept
+{
+    const auto full_cicle = CONV::semicircle * 2.0;
+
+    auto normalized = std::fmod( value, full_cicle );
+    if( normalized < -CONV::semicircle )
+    {
+        normalized += full_cicle;
+    }
+    else if( normalized > CONV::semicircle )
+    {
+        normalized -= full_cicle;
+    }
+
+    return static_cast< T >( normalized );
+}
+
+template< typename T, typename CONV >
+constexpr T normalize_abs( T value, std::true_type /* is_exact */ ) noexcept
+{
+    using work = work_t< T, CONV >;
+
+    constexpr auto full = static_cast< work >( full_circle< CONV >() );
+
+    // A full circle that is a power of two is a mask of the two's complement bits
+    const auto remainder = normalization::remainder< T, CONV >( value );
+    return ( full & ( full - 1 ) ) == 0 ? static_cast< T >( static_cast< std::uint64_t >( value ) & static_cast< std::uint64_t >( full - 1 ) ) :
+                                          static_cast< T >( remainder < 0 ? remainder + full : remainder );
+}
+
+template< typename T, typename CONV >
+inline T normalize_abs( T value, std::false_type /* is_exact */ ) noexcept
+{
+    const auto full_cicle = CONV::semicircle * 2.0;
+
+    auto normalized = std::fmod( value, full_cicle );
+    if( normalized < T() )
+    {
+        normalized += full_cicle;
+    }
+
+    return static_cast< T >( normalized );
+}
+
+}
+
 }
 
 
@@ -109,22 +228,15 @@ struct basic_angle
 
     /**
      * \brief Normalizes the angle object between -/+ semicircle.
+     *
+     * Integral angles with a whole number of units in a full circle are normalized exactly with integer arithmetic,
+     * which can also be done at compile time.
      */
-    void normalize() noexcept
+    constexpr void normalize() noexcept
     {
-        const auto full_cicle = CONV::semicircle * 2.0;
-
-        auto normalized = std::fmod( value, full_cicle );
-        if( normalized < CONV::semicircle )
-        {
-            normalized += full_cicle;
-        }
-        else if( normalized > CONV::semicircle )
-        {
-            normalized -= full_cicle;
-        }
-
-        value = static_cast< T >( normalized );
+        PG_TRIGONOMETRY_CONSTEXPR_PROBE( normalize, *this );
+
+        value = detail::normalization::normalize< T, CONV >( value, detail::normalization::is_exact< T, CONV >() );
     }
 
     /**
@@ -134,7 +246,7 @@ struct basic_angle
      * 
      * \return A normalized copy of the angle object.
      */
-    PG_TRIGONOMETRY_NODISCARD basic_angle< T, CONV > normalized() const noexcept
+    PG_TRIGONOMETRY_NODISCARD constexpr basic_angle< T, CONV > normalized() const noexcept
     {
         auto new_normalized = *this;
         new_normalized.normalize();
@@ -144,18 +256,15 @@ struct basic_angle
 
     /**
      * \brief Normalizes the angle object to a value between 0 to 2 * semicircle.
+     *
+     * Integral angles with a whole number of units in a full circle are normalized exactly with integer arithmetic,
+     * which can also be done at compile time.
      */
-    void normalize_abs() noexcept
+    constexpr void normalize_abs() noexcept
     {
-        const auto full_cicle = CONV::semicircle * 2.0;
+        PG_TRIGONOMETRY_CONSTEXPR_PROBE( normalize_abs, *this );
 
-        auto normalized = std::fmod( value, full_cicle );
-        if( normalized < T() )
-        {
-            normalized += full_cicle;
-        }
-
-        value = static_cast< T >( normalized );
+        value = detail::normalization::normalize_abs< T, CONV >( value, detail::normalization::is_exact< T, CONV >() );
     }
 
     /**
@@ -165,7 +274,7 @@ struct basic_angle
      * 
      * \return A normalized copy of the angle object.
      */
-    PG_TRIGONOMETRY_NODISCARD basic_angle< T, CONV > normalized_abs() const noexcept
+    PG_TRIGONOMETRY_NODISCARD constexpr basic_angle< T, CONV > normalized_abs() const noexcept
     {
         auto new_normalized = *this;
         new_normalized.normalize_abs();
@@ -303,6 +412,8 @@ PG_TRIGONOMETRY_NODISCARD inline basic_angle< T, CONV > round( basic_angle< T, C
 template< typename TO, typename FROM_T, typename FROM_CONV >
 PG_TRIGONOMETRY_NODISCARD inline TO angle_cast( const basic_angle< FROM_T, FROM_CONV > from ) noexcept
 {
+    PG_TRIGONOMETRY_PROBE( angle_cast, from );
+
     const auto new_angle = from.angle() * ( TO::conversion::semicircle / FROM_CONV::semicircle );
     return { static_cast< typename TO::value_type >( new_angle ) };
 }
@@ -335,18 +446,466 @@ using deg  = basic_angle< double, deg_conv >;
 using rad  = basic_angle< double, rad_conv >;
 using grad = basic_angle< double, grad_conv >;
 
+/**
+ * \brief Precision policy that uses the functions of the standard library.
+ *
+ * The batch functions use minimax polynomials with an absolute error below \em max_error instead.
+ */
+struct precise
+{
+    constexpr static double max_error = 1e-15;
+};
+
+/**
+ * \brief Precision policy that uses low degree minimax polynomials.
+ */
+struct fast
+{
+    constexpr static double max_error = 1e-7;
+};
+
+/**
+ * \brief Precision policy that uses an interpolated table for sine and cosine and a quadratic polynomial for arc tangent.
+ */
+struct fastest
+{
+    constexpr static double max_error = 1e-4;
+};
+
+namespace detail
+{
+
+namespace trig
+{
+
+template< typename... >
+struct make_void
+{
+    using type = void;
+};
+
+template< typename CONV, typename = void >
+struct conversion_precision
+{
+    using type = precise;
+};
+
+template< typename CONV >
+struct conversion_precision< CONV, typename make_void< typename CONV::precision >::type >
+{
+    using type = typename CONV::precision;
+};
+
+// The precision policy passed as template argument or otherwise the policy of the conversion object
+template< typename P, typename CONV >
+using precision_t = typename std::conditional< std::is_void< P >::value, typename conversion_precision< CONV >::type, P >::type;
+
+constexpr long double pi_ld = 3.141592653589793238462643383279502884L;
+
+constexpr double tan_pi_8 = 0.41421356237309504880;
+
+// Minimax coefficients of sin( t ) / t, cos( t ) and atan( t ) / t as polynomials of t^2.
+// The sine and cosine polynomials cover |t| <= pi / 4 and the arc tangent polynomials |t| <= tan( pi / 8 ).
+constexpr double precise_sin_coefficients[] =
+{
+     1.00000000000000000e+00,
+    -1.66666666666666158e-01,
+     8.33333333332039392e-03,
+    -1.98412698286679588e-04,
+     2.75573133811662892e-06,
+    -2.50507175825626453e-08,
+     1.58947662253764109e-10
+};
+
+constexpr double precise_cos_coefficients[] =
+{
+     1.00000000000000000e+00,
+    -4.99999999999992506e-01,
+     4.16666666664724517e-02,
+    -1.38888888699884375e-03,
+     2.48015785415624034e-05,
+    -2.75552343098593925e-07,
+     2.06304770361649145e-09
+};
+
+constexpr double precise_atan_coefficients[] =
+{
+     1.00000000000000000e+00,
+    -3.33333333333287168e-01,
+     1.99999999989084556e-01,
+    -1.42857141849446216e-01,
+     1.11111063304105752e-01,
+    -9.09077633066734133e-02,
+     7.68999654275397172e-02,
+    -6.64058623561921633e-02,
+     5.69009192482302766e-02,
+    -4.35282538240328499e-02,
+     2.11909419478243632e-02
+};
+
+constexpr double fast_sin_coefficients[] =
+{
+     9.99999996926348889e-01,
+    -1.66666506992102809e-01,
+     8.33203687528692900e-03,
+    -1.95040220006282455e-04
+};
+
+constexpr double fast_cos_coefficients[] =
+{
+     9.99999972423404437e-01,
+    -4.99998566959543755e-01,
+     4.16550268859580478e-02,
+    -1.35859085100441257e-03
+};
+
+constexpr double fast_atan_coefficients[] =
+{
+     9.99999982460719861e-01,
+    -3.33328079017722712e-01,
+     1.99747243063068625e-01,
+    -1.38544576858511931e-01,
+     7.99364423351832248e-02
+};
+
+constexpr double fastest_atan_coefficients[] =
+{
+     9.99982445825990718e-01,
+    -3.31412500671352472e-01,
+     1.68356510726861447e-01
+};
+
+template< std::size_t N >
+inline double polynomial( const double ( & coefficients )[ N ], double z ) noexcept
+{
+    auto result = coefficients[ N - 1 ];
+    for( std::size_t i = N - 1 ; i > 0 ; --i )
+    {
+        result = result * z + coefficients[ i - 1 ];
+    }
+    return result;
+}
+
+inline double sin_polynomial( double z, precise ) noexcept { return polynomial( precise_sin_coefficients, z ); }
+inline double sin_polynomial( double z, fast ) noexcept    { return polynomial( fast_sin_coefficients, z ); }
+inline double cos_polynomial( double z, precise ) noexcept { return polynomial( precise_cos_coefficients, z ); }
+inline double cos_polynomial( double z, fast ) noexcept    { return polynomial( fast_cos_coefficients, z ); }
+inline double atan_polynomial( double z, precise ) noexcept { return polynomial( precise_atan_coefficients, z ); }
+inline double atan_polynomial( double z, fast ) noexcept    { return polynomial( fast_atan_coefficients, z ); }
+inline double atan_polynomial( double z, fastest ) noexcept { return polynomial( fastest_atan_coefficients, z ); }
+
+// Polynomials of the kernels for angles in the unit of \em CONV; the angles are converted to radians
+template< typename CONV, typename P, typename = void >
+struct kernel_polynomials
+{
+    constexpr static double argument_scale = static_cast< double >( pi_ld / CONV::semicircle );
+
+    static double sin( double z ) noexcept  { return sin_polynomial( z, P() ); }
+    static double cos( double z ) noexcept  { return cos_polynomial( z, P() ); }
+    static double atan( double z ) noexcept { return static_cast< double >( CONV::semicircle / pi_ld ) * atan_polynomial( z, P() ); }
+};
+
+// Polynomials generated by tools/minimax.cpp for the unit of \em CONV and policy \em P evaluate the angles in that unit
+template< typename CONV, typename P >
+struct kernel_polynomials< CONV, P, typename std::enable_if< std::is_same< typename CONV::coefficients::precision, P >::value >::type >
+{
+    using coefficients = typename CONV::coefficients;
+
+    static_assert( coefficients::semicircle == CONV::semicircle, "The coefficients are generated for another unit" );
+
+    constexpr static double argument_scale = 1.0;
+
+    static double sin( double z ) noexcept  { return coefficients::sin( z ); }
+    static double cos( double z ) noexcept  { return coefficients::cos( z ); }
+    static double atan( double z ) noexcept { return coefficients::atan( z ); }
+};
+
+// Rounds to a value with at most 32 significant bits so that multiples up to 2^20 are exact in a double
+constexpr double high_part( long double value )
+{
+    long double scale = 1.0L;
+    while( value * scale >= 4294967296.0L )
+    {
+        scale /= 2.0L;
+    }
+    while( value * scale < 2147483648.0L )
+    {
+        scale *= 2.0L;
+    }
+    return static_cast< double >( static_cast< long double >( static_cast< unsigned long long >( value * scale ) ) / scale );
+}
+
+// Quarter circles beyond which the polynomial kernels defer to the standard library
+constexpr double kernel_domain = 1048576.0;
+
+// Whether \em x in the unit of \em CONV is in the domain of the polynomial kernels; false when \em x is not finite
+template< typename CONV, typename P >
+inline bool in_kernel_domain( double x, P /* policy */ ) noexcept
+{
+    constexpr auto quarter = static_cast< double >( CONV::semicircle / 2.0L );
+    return std::fabs( x * ( 1.0 / quarter ) ) < kernel_domain;
+}
+
+// The domain of the table kernel, in 1 / 256 of a circle
+template< typename CONV >
+inline bool in_kernel_domain( double x, fastest ) noexcept
+{
+    constexpr auto to_steps = static_cast< double >( 128.0L / CONV::semicircle );
+    return std::fabs( x * to_steps ) < 4.0 * kernel_domain * 64.0;
+}
+
+// Subtracts q quarter circles from x in the unit of CONV. The quarter circle is split in two parts, so the reduction is
+// exact for units such as degrees and for units with a semicircle that is not a double.
+template< typename CONV, typename = void >
+struct quarter_reduction
+{
+    constexpr static double hi = high_part( CONV::semicircle / 2.0L );
+    constexpr static double lo = static_cast< double >( CONV::semicircle / 2.0L - hi );
+
+    static double reduce( double x, double q ) noexcept
+    {
+        return ( x - q * hi ) - q * lo;
+    }
+};
+
+// A semicircle of pi rounded to a double is the unit of std::sin; radians are reduced by the exact pi / 2 with
+// Cody-Waite constants of 33 + 33 + 53 bits, so the error stays far below that of the polynomials up to 2^20 quarter circles.
+template< typename CONV >
+struct quarter_reduction< CONV, typename std::enable_if< static_cast< double >( CONV::semicircle ) == pi >::type >
+{
+    constexpr static double hi  = 1.57079632673412561417e+00;
+    constexpr static double mid = 6.07710050630396597660e-11;
+    constexpr static double lo  = 2.02226624879595063154e-21;
+
+    static double reduce( double x, double q ) noexcept
+    {
+        return ( ( x - q * hi ) - q * mid ) - q * lo;
+    }
+};
+
+/**
+ * Computes sine and cosine of \em x in the unit of \em CONV with minimax polynomials.
+ *
+ * The reduction to a quarter circle is done in the unit of \em CONV, which is exact for units such as degrees;
+ * see \em quarter_reduction for units such as radians.
+ *
+ * \return False when \em x is out of the domain of the kernel or not finite; the results are not valid.
+ */
+template< typename CONV, typename P >
+inline bool sincos_kernel( double x, double & sin_result, double & cos_result, P /* policy */ ) noexcept
+{
+    constexpr auto quarter = static_cast< double >( CONV::semicircle / 2.0L );
+    using polynomials = kernel_polynomials< CONV, P >;
+
+    const auto v         = x * ( 1.0 / quarter );
+    const auto in_domain = in_kernel_domain< CONV >( x, P() );
+    const auto vr        = in_domain ? v : 0.0;
+    const auto qi        = static_cast< std::int32_t >( vr + std::copysign( 0.5, vr ) );
+    const auto q         = static_cast< double >( qi );
+    const auto t         = quarter_reduction< CONV >::reduce( x, q ) * polynomials::argument_scale;
+    const auto z         = t * t;
+    const auto s         = t * polynomials::sin( z );
+    const auto c         = polynomials::cos( z );
+
+    const auto swap      = ( qi & 1 ) != 0;
+    const auto sin_value = swap ? c : s;
+    const auto cos_value = swap ? s : c;
+    sin_result = ( qi & 2 ) ? -sin_value : sin_value;
+    cos_result = ( ( qi + 1 ) & 2 ) ? -cos_value : cos_value;
+
+    return in_domain;
+}
+
+struct sine_table
+{
+    // Sine of k / 256 of a circle for k in [0, 320], the cosine starts at k = 64
+    double values[ 321 ];
+};
+
+constexpr long double table_sine( int k )
+{
+    k %= 256;
+    auto x = ( k > 128 ? k - 256 : k ) * pi_ld / 128.0L;
+    auto term = x;
+    auto sum  = x;
+    for( int n = 1 ; n < 30 ; ++n )
+    {
+        term *= -x * x / ( ( 2 * n ) * ( 2 * n + 1 ) );
+        sum  += term;
+    }
+    return sum;
+}
+
+constexpr sine_table make_sine_table()
+{
+    sine_table table = {};
+    for( int k = 0 ; k < 321 ; ++k )
+    {
+        table.values[ k ] = static_cast< double >( table_sine( k ) );
+    }
+    return table;
+}
+
+template< typename = void >
+struct sine_table_holder
+{
+    constexpr static sine_table table = make_sine_table();
+};
+
+template< typename V >
+constexpr sine_table sine_table_holder< V >::table;
+
+/**
+ * Computes sine and cosine of \em x in the unit of \em CONV by linear interpolation of a 256 entries table.
+ *
+ * \return False when \em x is out of the domain of the kernel or not finite; the results are not valid.
+ */
+template< typename CONV >
+inline bool sincos_kernel( double x, double & sin_result, double & cos_result, fastest ) noexcept
+{
+    constexpr auto to_steps = static_cast< double >( 128.0L / CONV::semicircle );
+
+    const auto u         = x * to_steps;
+    const auto in_domain = in_kernel_domain< CONV >( x, fastest() );
+    const auto ur        = in_domain ? u : 0.0;
+    auto       i         = static_cast< std::int32_t >( ur );
+    i -= ur < i;
+
+    const auto   f      = ur - i;
+    const auto   k      = static_cast< std::size_t >( i & 255 );
+    const auto & values = sine_table_holder<>::table.values;
+    sin_result = values[ k ] + f * ( values[ k + 1 ] - values[ k ] );
+    cos_result = values[ k + 64 ] + f * ( values[ k + 65 ] - values[ k + 64 ] );
+
+    return in_domain;
+}
+
+/**
+ * Branch-free arc tangent of y/x in the unit of an angle type with a \em semicircle.
+ *
+ * \em scaled_atan returns atan( t ) / t in the unit for z = t^2 so that the scale from radians to the unit
+ * is folded into the polynomial and the quadrant offsets and no separate conversion is needed on the result.
+ */
+template< typename ATAN >
+inline double atan2_reduction( double y, double x, double semicircle, ATAN scaled_atan ) noexcept
+{
+    const auto ay    = std::fabs( y );
+    const auto ax    = std::fabs( x );
+    const auto swap  = ay > ax;
+    const auto num   = swap ? ax : ay;
+    const auto den   = swap ? ay : ax;
+
+    // atan( a ) = pi / 4 + atan( ( a - 1 ) / ( a + 1 ) ) for a = num / den > tan( pi / 8 )
+    const auto reduce = num > tan_pi_8 * den;
+    const auto n      = reduce ? num - den : num;
+    const auto d      = reduce ? num + den : den;
+    const auto t      = n / ( d == 0.0 ? 1.0 : d );
+
+    auto result = t * scaled_atan( t * t ) + ( reduce ? semicircle / 4.0 : 0.0 );
+    result = swap ? semicircle / 2.0 - result : result;
+    result = std::copysign( 1.0, x ) < 0.0 ? semicircle - result : result;
+
+    return std::copysign( result, y );
+}
+
+/**
+ * Arc tangent of y/x in a unit with a \em semicircle that has no conversion object.
+ */
+template< typename P >
+inline double atan2_kernel( double y, double x, double semicircle, P policy ) noexcept
+{
+    const auto scale = semicircle / pi;
+    return atan2_reduction( y, x, semicircle, [ = ]( double z ) { return scale * atan_polynomial( z, policy ); } );
+}
+
+/**
+ * Arc tangent of y/x in the unit of \em CONV.
+ */
+template< typename CONV, typename P >
+inline double atan2_kernel( double y, double x, P /* policy */ ) noexcept
+{
+    return atan2_reduction( y, x, static_cast< double >( CONV::semicircle ), []( double z ) { return kernel_polynomials< CONV, P >::atan( z ); } );
+}
+
+template< typename T, typename CONV >
+inline auto sin( basic_angle< T, CONV > x, precise ) noexcept
+{
+    auto radians = pi * x.angle() / CONV::semicircle;
+    return std::sin( radians );
+}
+
+template< typename T, typename CONV, typename P >
+inline double sin( basic_angle< T, CONV > x, P policy ) noexcept
+{
+    double s;
+    double c;
+    return sincos_kernel< CONV >( x.angle(), s, c, policy ) ? s : static_cast< double >( sin( x, precise() ) );
+}
+
+template< typename T, typename CONV >
+inline auto cos( basic_angle< T, CONV > x, precise ) noexcept
+{
+    auto radians = pi * x.angle() / CONV::semicircle;
+    return std::cos( radians );
+}
+
+template< typename T, typename CONV, typename P >
+inline double cos( basic_angle< T, CONV > x, P policy ) noexcept
+{
+    double s;
+    double c;
+    return sincos_kernel< CONV >( x.angle(), s, c, policy ) ? c : static_cast< double >( cos( x, precise() ) );
+}
+
+template< typename T, typename CONV >
+inline auto tan( basic_angle< T, CONV > x, precise ) noexcept
+{
+    auto radians = pi * x.angle() / CONV::semicircle;
+    return std::tan( radians );
+}
+
+template< typename T, typename CONV, typename P >
+inline double tan( basic_angle< T, CONV > x, P policy ) noexcept
+{
+    double s;
+    double c;
+    return sincos_kernel< CONV >( x.angle(), s, c, policy ) ? s / c : static_cast< double >( tan( x, precise() ) );
+}
+
+template< typename TO, typename T1, typename T2 >
+inline TO atan2( T1 y, T2 x, precise ) noexcept
+{
+    auto value = TO::conversion::semicircle * std::atan2( y, x ) / pi;
+    return { static_cast< typename TO::value_type >( value ) };
+}
+
+template< typename TO, typename T1, typename T2, typename P >
+inline TO atan2( T1 y, T2 x, P policy ) noexcept
+{
+    const auto value = atan2_kernel< typename TO::conversion >( y, x, policy );
+    return { static_cast< typename TO::value_type >( value ) };
+}
+
+}
+
+}
+
 /**
  * \brief Computes sine.
  * 
+ * \tparam P The precision policy; \em precise, \em fast or \em fastest.
+ *           Defaults to the \em precision of the conversion object of \em x when available, otherwise \em precise.
+ * 
  * \param x An angle object.
  * 
  * \return The sine of \em x.
  */
-template< typename CONV, typename T >
+template< typename P = void, typename T, typename CONV >
 PG_TRIGONOMETRY_NODISCARD inline auto sin( basic_angle< T, CONV > x ) noexcept
 {
-    auto radians = detail::trig::pi * x.angle() / CONV::semicircle;
-    return std::sin( radians );
+    PG_TRIGONOMETRY_PROBE( sin, x );
+
+    return detail::trig::sin( x, detail::trig::precision_t< P, CONV >() );
 }
 
 /**
@@ -369,15 +928,19 @@ PG_TRIGONOMETRY_NODISCARD inline TO asin( T x ) noexcept
 /**
  * \brief Computes cosine.
  * 
+ * \tparam P The precision policy; \em precise, \em fast or \em fastest.
+ *           Defaults to the \em precision of the conversion object of \em x when available, otherwise \em precise.
+ * 
  * \param x An angle object.
  * 
  * \return The cosine of \em x.
  */
-template< typename T, typename CONV >
+template< typename P = void, typename T, typename CONV >
 PG_TRIGONOMETRY_NODISCARD inline auto cos( basic_angle< T, CONV > x ) noexcept
 {
-    auto radians = detail::trig::pi * x.angle() / CONV::semicircle;
-    return std::cos( radians );
+    PG_TRIGONOMETRY_PROBE( cos, x );
+
+    return detail::trig::cos( x, detail::trig::precision_t< P, CONV >() );
 }
 
 /**
@@ -400,15 +963,19 @@ PG_TRIGONOMETRY_NODISCARD inline TO acos( T x ) noexcept
 /**
  * \brief Computes tangent.
  * 
+ * \tparam P The precision policy; \em precise, \em fast or \em fastest.
+ *           Defaults to the \em precision of the conversion object of \em x when available, otherwise \em precise.
+ * 
  * \param x An angle object.
  * 
  * \return The tangent of \em x.
  */
-template< typename T, typename CONV >
+template< typename P = void, typename T, typename CONV >
 PG_TRIGONOMETRY_NODISCARD inline auto tan( basic_angle< T, CONV > x ) noexcept
 {
-    auto radians = detail::trig::pi * x.angle() / CONV::semicircle;
-    return std::tan( radians );
+    PG_TRIGONOMETRY_PROBE( tan, x );
+
+    return detail::trig::tan( x, detail::trig::precision_t< P, CONV >() );
 }
 
 /**
@@ -432,6 +999,8 @@ PG_TRIGONOMETRY_NODISCARD inline TO atan( T x ) noexcept
  * \brief Computes the arc tangent of y/x using the signs of arguments to determine the correct quadrant.
  * 
  * \tparam TO The resulting angle object type containing the arc tangent of \em x.
+ * \tparam P  The precision policy; \em precise, \em fast or \em fastest.
+ *            Defaults to the \em precision of the conversion object of \em TO when available, otherwise \em precise.
  * \tparam T1 The arithmetic type of \em y.
  * \tparam T2 The arithmetic type of \em x.
  * 
@@ -440,11 +1009,10 @@ PG_TRIGONOMETRY_NODISCARD inline TO atan( T x ) noexcept
  * 
  * \return The arc tangent of \em y, \em x as \em TO.
  */
-template< typename TO = rad, typename T1, typename T2 >
+template< typename TO = rad, typename P = void, typename T1, typename T2 >
 PG_TRIGONOMETRY_NODISCARD inline TO atan2( T1 y, T2 x ) noexcept
 {
-    auto value = TO::conversion::semicircle * std::atan2( y, x ) / detail::trig::pi;
-    return { static_cast< typename TO::value_type >( value ) };
+    return detail::trig::atan2< TO >( y, x, detail::trig::precision_t< P, typename TO::conversion >() );
 }
 
 namespace trigonometric_literals
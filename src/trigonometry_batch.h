@@ -0,0 +1,494 @@
+// See LICENSE for the Copyright Notice
+
+#pragma once
+
+#include "trigonometry.h"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+namespace pg
+{
+
+namespace math
+{
+
+namespace detail
+{
+
+namespace batch
+{
+
+// Rounds to nearest. The conversion of NaN and of values beyond the range of T is undefined, so NaN becomes 0 and the
+// other values saturate.
+template< typename T >
+inline T from_double( double value, std::true_type /* is_integral */ ) noexcept
+{
+    constexpr auto lowest  = static_cast< double >( std::numeric_limits< T >::lowest() );
+    constexpr auto highest = static_cast< double >( std::numeric_limits< T >::max() );
+
+    const auto rounded = value + std::copysign( 0.5, value );
+    return rounded >= highest ? std::numeric_limits< T >::max()
+         : rounded <= lowest  ? std::numeric_limits< T >::lowest()
+         : rounded == rounded ? static_cast< T >( rounded )
+         : T( 0 );
+}
+
+template< typename T >
+inline T from_double( double value, std::false_type /* is_integral */ ) noexcept
+{
+    return static_cast< T >( value );
+}
+
+template< typename TO >
+inline TO make_angle( double value ) noexcept
+{
+    using value_type = typename TO::value_type;
+    return { from_double< value_type >( value, std::is_integral< value_type >() ) };
+}
+
+template< typename TO >
+constexpr double semicircle() noexcept
+{
+    return static_cast< double >( TO::conversion::semicircle );
+}
+
+// Whether all the elements of an array are in the domain of the kernel. The check is a separate pass with a floating point
+// select reduction, since an integral reduction of the results of the kernel keeps gcc from vectorizing the kernel loop.
+template< typename T, typename CONV, typename P >
+inline bool in_kernel_domain( const basic_angle< T, CONV > * x, std::size_t count, P policy ) noexcept
+{
+    auto outside = 0.0;
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        outside = trig::in_kernel_domain< CONV >( static_cast< double >( x[ i ].angle() ), policy ) ? outside : 1.0;
+    }
+    return outside == 0.0;
+}
+
+// Runs the sine and cosine kernel over an array and passes each result to \em store.
+// Values outside the domain of the kernel are computed afterwards with the standard library.
+template< typename T, typename CONV, typename P, typename STORE >
+inline void sincos_loop( const basic_angle< T, CONV > * x, std::size_t count, P policy, STORE store ) noexcept
+{
+    const auto in_domain = in_kernel_domain( x, count, policy );
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        double s;
+        double c;
+        trig::sincos_kernel< CONV >( x[ i ].angle(), s, c, policy );
+        store( i, s, c );
+    }
+
+    if( !in_domain )
+    {
+        for( std::size_t i = 0 ; i < count ; ++i )
+        {
+            if( !trig::in_kernel_domain< CONV >( static_cast< double >( x[ i ].angle() ), policy ) )
+            {
+                store( i, static_cast< double >( trig::sin( x[ i ], precise() ) ),
+                          static_cast< double >( trig::cos( x[ i ], precise() ) ) );
+            }
+        }
+    }
+}
+
+// Sine and cosine of each element of a std::array. The loops have a trip count that is known at compile time and the kernel
+// writes to local arrays, so the compiler vectorizes them without aliasing checks or remainder loops.
+template< typename T, typename CONV, std::size_t N, typename P >
+inline void sincos_fixed( const std::array< basic_angle< T, CONV >, N > & angles, std::array< double, N > & sin_result, std::array< double, N > & cos_result,
+                          P policy ) noexcept
+{
+    const auto              in_domain = in_kernel_domain( angles.data(), N, policy );
+    std::array< double, N > s;
+    std::array< double, N > c;
+    for( std::size_t i = 0 ; i < N ; ++i )
+    {
+        trig::sincos_kernel< CONV >( angles[ i ].angle(), s[ i ], c[ i ], policy );
+    }
+
+    if( !in_domain )
+    {
+        for( std::size_t i = 0 ; i < N ; ++i )
+        {
+            if( !trig::in_kernel_domain< CONV >( static_cast< double >( angles[ i ].angle() ), policy ) )
+            {
+                s[ i ] = static_cast< double >( trig::sin( angles[ i ], precise() ) );
+                c[ i ] = static_cast< double >( trig::cos( angles[ i ], precise() ) );
+            }
+        }
+    }
+
+    for( std::size_t i = 0 ; i < N ; ++i )
+    {
+        sin_result[ i ] = s[ i ];
+        cos_result[ i ] = c[ i ];
+    }
+}
+
+}
+
+}
+
+/**
+ * \brief Normalizes an array of angle objects between -/+ semicircle.
+ *
+ * For integral angles with up to 32 bits the loop is vectorizable.
+ *
+ * \param angles Pointer to the angle objects.
+ * \param count  The number of angle objects.
+ */
+template< typename T, typename CONV >
+inline void normalize( basic_angle< T, CONV > * angles, std::size_t count ) noexcept
+{
+    normalized( angles, count, angles );
+}
+
+/**
+ * \brief Computes normalized copies between -/+ semicircle of an array of angle objects.
+ *
+ * For integral angles with up to 32 bits the loop is vectorizable.
+ *
+ * \param angles Pointer to the angle objects.
+ * \param count  The number of angle objects.
+ * \param result Pointer to the array that receives \em count normalized angle objects; may be the same as \em angles.
+ */
+template< typename T, typename CONV >
+inline void normalized( const basic_angle< T, CONV > * angles, std::size_t count, basic_angle< T, CONV > * result ) noexcept
+{
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        result[ i ] = detail::normalization::normalize< T, CONV >( angles[ i ].angle(), detail::normalization::is_exact< T, CONV >() );
+    }
+}
+
+/**
+ * \brief Normalizes an array of angle objects between 0 and 2 * semicircle.
+ *
+ * For integral angles with up to 32 bits the loop is vectorizable.
+ *
+ * \param angles Pointer to the angle objects.
+ * \param count  The number of angle objects.
+ */
+template< typename T, typename CONV >
+inline void normalize_abs( basic_angle< T, CONV > * angles, std::size_t count ) noexcept
+{
+    normalized_abs( angles, count, angles );
+}
+
+/**
+ * \brief Computes normalized copies between 0 and 2 * semicircle of an array of angle objects.
+ *
+ * For integral angles with up to 32 bits the loop is vectorizable.
+ *
+ * \param angles Pointer to the angle objects.
+ * \param count  The number of angle objects.
+ * \param result Pointer to the array that receives \em count normalized angle objects; may be the same as \em angles.
+ */
+template< typename T, typename CONV >
+inline void normalized_abs( const basic_angle< T, CONV > * angles, std::size_t count, basic_angle< T, CONV > * result ) noexcept
+{
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        result[ i ] = detail::normalization::normalize_abs< T, CONV >( angles[ i ].angle(), detail::normalization::is_exact< T, CONV >() );
+    }
+}
+
+/**
+ * \brief Computes the sine and cosine of an array of angle objects.
+ *
+ * The \em precise policy uses minimax polynomials for the batch functions instead of the standard library.
+ *
+ * \tparam P The precision policy; \em precise, \em fast or \em fastest.
+ *           Defaults to the \em precision of the conversion object when available, otherwise \em precise.
+ *
+ * \param x          Pointer to the angle objects.
+ * \param count      The number of angle objects.
+ * \param sin_result Pointer to the array that receives \em count sines.
+ * \param cos_result Pointer to the array that receives \em count cosines.
+ */
+template< typename P = void, typename T, typename CONV >
+inline void sincos( const basic_angle< T, CONV > * x, std::size_t count, double * sin_result, double * cos_result ) noexcept
+{
+    detail::batch::sincos_loop( x, count, detail::trig::precision_t< P, CONV >(), [ = ]( std::size_t i, double s, double c )
+    {
+        sin_result[ i ] = s;
+        cos_result[ i ] = c;
+    } );
+}
+
+/**
+ * \brief Computes the sine of an array of angle objects.
+ *
+ * \tparam P The precision policy; \em precise, \em fast or \em fastest.
+ *           Defaults to the \em precision of the conversion object when available, otherwise \em precise.
+ *
+ * \param x      Pointer to the angle objects.
+ * \param count  The number of angle objects.
+ * \param result Pointer to the array that receives \em count sines.
+ */
+template< typename P = void, typename T, typename CONV >
+inline void sin( const basic_angle< T, CONV > * x, std::size_t count, double * result ) noexcept
+{
+    detail::batch::sincos_loop( x, count, detail::trig::precision_t< P, CONV >(), [ = ]( std::size_t i, double s, double )
+    {
+        result[ i ] = s;
+    } );
+}
+
+/**
+ * \brief Computes the cosine of an array of angle objects.
+ *
+ * \tparam P The precision policy; \em precise, \em fast or \em fastest.
+ *           Defaults to the \em precision of the conversion object when available, otherwise \em precise.
+ *
+ * \param x      Pointer to the angle objects.
+ * \param count  The number of angle objects.
+ * \param result Pointer to the array that receives \em count cosines.
+ */
+template< typename P = void, typename T, typename CONV >
+inline void cos( const basic_angle< T, CONV > * x, std::size_t count, double * result ) noexcept
+{
+    detail::batch::sincos_loop( x, count, detail::trig::precision_t< P, CONV >(), [ = ]( std::size_t i, double, double c )
+    {
+        result[ i ] = c;
+    } );
+}
+
+/**
+ * \brief Computes the tangent of an array of angle objects.
+ *
+ * \tparam P The precision policy; \em precise, \em fast or \em fastest.
+ *           Defaults to the \em precision of the conversion object when available, otherwise \em precise.
+ *
+ * \param x      Pointer to the angle objects.
+ * \param count  The number of angle objects.
+ * \param result Pointer to the array that receives \em count tangents.
+ */
+template< typename P = void, typename T, typename CONV >
+inline void tan( const basic_angle< T, CONV > * x, std::size_t count, double * result ) noexcept
+{
+    detail::batch::sincos_loop( x, count, detail::trig::precision_t< P, CONV >(), [ = ]( std::size_t i, double s, double c )
+    {
+        result[ i ] = s / c;
+    } );
+}
+
+/**
+ * \brief Computes the arc sine of an array of values.
+ *
+ * The values are converted into the unit of \em TO by the polynomial kernel itself.
+ * Results for integral \em TO types are rounded to the nearest integer; NaN results, e.g. for values beyond -/+ 1,
+ * become 0 and results beyond the range of the type saturate.
+ *
+ * \tparam TO The resulting angle object type containing the arc sines.
+ * \tparam P  The precision policy; \em precise, \em fast or \em fastest.
+ * \tparam T  The arithmetic type of the values.
+ *
+ * \param x      Pointer to the values for wich the arc sine is calculated.
+ * \param count  The number of values.
+ * \param result Pointer to the array that receives \em count arc sines.
+ */
+template< typename TO = rad, typename P = void, typename T >
+inline void asin( const T * x, std::size_t count, TO * result ) noexcept
+{
+    const auto policy = detail::trig::precision_t< P, typename TO::conversion >();
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        const double v = x[ i ];
+        const auto   r = detail::trig::atan2_kernel< typename TO::conversion >( v, std::sqrt( ( 1.0 - v ) * ( 1.0 + v ) ), policy );
+        result[ i ] = detail::batch::make_angle< TO >( r );
+    }
+}
+
+/**
+ * \brief Computes the arc cosine of an array of values.
+ *
+ * The values are converted into the unit of \em TO by the polynomial kernel itself.
+ * Results for integral \em TO types are rounded to the nearest integer; NaN results, e.g. for values beyond -/+ 1,
+ * become 0 and results beyond the range of the type saturate.
+ *
+ * \tparam TO The resulting angle object type containing the arc cosines.
+ * \tparam P  The precision policy; \em precise, \em fast or \em fastest.
+ * \tparam T  The arithmetic type of the values.
+ *
+ * \param x      Pointer to the values for wich the arc cosine is calculated.
+ * \param count  The number of values.
+ * \param result Pointer to the array that receives \em count arc cosines.
+ */
+template< typename TO = rad, typename P = void, typename T >
+inline void acos( const T * x, std::size_t count, TO * result ) noexcept
+{
+    const auto policy = detail::trig::precision_t< P, typename TO::conversion >();
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        const double v = x[ i ];
+        const auto   r = detail::trig::atan2_kernel< typename TO::conversion >( std::sqrt( ( 1.0 - v ) * ( 1.0 + v ) ), v, policy );
+        result[ i ] = detail::batch::make_angle< TO >( r );
+    }
+}
+
+/**
+ * \brief Computes the arc tangent of an array of values.
+ *
+ * The values are converted into the unit of \em TO by the polynomial kernel itself.
+ * Results for integral \em TO types are rounded to the nearest integer; NaN results become 0 and results beyond the
+ * range of the type saturate.
+ *
+ * \tparam TO The resulting angle object type containing the arc tangents.
+ * \tparam P  The precision policy; \em precise, \em fast or \em fastest.
+ * \tparam T  The arithmetic type of the values.
+ *
+ * \param x      Pointer to the values for wich the arc tangent is calculated.
+ * \param count  The number of values.
+ * \param result Pointer to the array that receives \em count arc tangents.
+ */
+template< typename TO = rad, typename P = void, typename T >
+inline void atan( const T * x, std::size_t count, TO * result ) noexcept
+{
+    const auto policy = detail::trig::precision_t< P, typename TO::conversion >();
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        const auto r = detail::trig::atan2_kernel< typename TO::conversion >( x[ i ], 1.0, policy );
+        result[ i ] = detail::batch::make_angle< TO >( r );
+    }
+}
+
+/**
+ * \brief Computes the arc tangent of y/x for arrays of values using the signs to determine the correct quadrant.
+ *
+ * The values are converted into the unit of \em TO by the polynomial kernel itself.
+ * Results for integral \em TO types are rounded to the nearest integer; NaN results become 0 and results beyond the
+ * range of the type saturate.
+ *
+ * \tparam TO The resulting angle object type containing the arc tangents.
+ * \tparam P  The precision policy; \em precise, \em fast or \em fastest.
+ * \tparam T1 The arithmetic type of the \em y values.
+ * \tparam T2 The arithmetic type of the \em x values.
+ *
+ * \param y      Pointer to the \em y values.
+ * \param x      Pointer to the \em x values.
+ * \param count  The number of values in \em y and \em x.
+ * \param result Pointer to the array that receives \em count arc tangents.
+ */
+template< typename TO = rad, typename P = void, typename T1, typename T2 >
+inline void atan2( const T1 * y, const T2 * x, std::size_t count, TO * result ) noexcept
+{
+    const auto policy = detail::trig::precision_t< P, typename TO::conversion >();
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        const auto r = detail::trig::atan2_kernel< typename TO::conversion >( y[ i ], x[ i ], policy );
+        result[ i ] = detail::batch::make_angle< TO >( r );
+    }
+}
+
+/**
+ * \brief Computes the sine and cosine of a fixed size array of angle objects.
+ *
+ * The size is known at compile time, so the computation is unrolled and fits in one or two vector registers for small arrays.
+ *
+ * \tparam P The precision policy; \em precise, \em fast or \em fastest.
+ *           Defaults to the \em precision of the conversion object when available, otherwise \em precise.
+ *
+ * \param x          The angle objects.
+ * \param sin_result Receives the sines.
+ * \param cos_result Receives the cosines.
+ */
+template< typename P = void, typename T, typename CONV, std::size_t N >
+inline void sincos( const std::array< basic_angle< T, CONV >, N > & x, std::array< double, N > & sin_result, std::array< double, N > & cos_result ) noexcept
+{
+    detail::batch::sincos_fixed( x, sin_result, cos_result, detail::trig::precision_t< P, CONV >() );
+}
+
+/**
+ * \brief Computes the sine of a fixed size array of angle objects; see \em sincos.
+ */
+template< typename P = void, typename T, typename CONV, std::size_t N >
+PG_TRIGONOMETRY_NODISCARD inline std::array< double, N > sin( const std::array< basic_angle< T, CONV >, N > & x ) noexcept
+{
+    std::array< double, N > s;
+    std::array< double, N > c;
+    sincos< P >( x, s, c );
+    return s;
+}
+
+/**
+ * \brief Computes the cosine of a fixed size array of angle objects; see \em sincos.
+ */
+template< typename P = void, typename T, typename CONV, std::size_t N >
+PG_TRIGONOMETRY_NODISCARD inline std::array< double, N > cos( const std::array< basic_angle< T, CONV >, N > & x ) noexcept
+{
+    std::array< double, N > s;
+    std::array< double, N > c;
+    sincos< P >( x, s, c );
+    return c;
+}
+
+/**
+ * \brief Returns a copy of a fixed size array of angle objects normalized between -/+ semicircle.
+ */
+template< typename T, typename CONV, std::size_t N >
+PG_TRIGONOMETRY_NODISCARD inline std::array< basic_angle< T, CONV >, N > normalized( const std::array< basic_angle< T, CONV >, N > & angles ) noexcept
+{
+    auto result = angles;
+    for( std::size_t i = 0 ; i < N ; ++i )
+    {
+        result[ i ] = basic_angle< T, CONV >( detail::normalization::normalize< T, CONV >( result[ i ].angle(), detail::normalization::is_exact< T, CONV >() ) );
+    }
+    return result;
+}
+
+/**
+ * \brief Normalizes a fixed size array of angle objects between -/+ semicircle.
+ */
+template< typename T, typename CONV, std::size_t N >
+inline void normalize( std::array< basic_angle< T, CONV >, N > & angles ) noexcept
+{
+    angles = normalized( angles );
+}
+
+/**
+ * \brief Returns a copy of a fixed size array of angle objects normalized between 0 and 2 * semicircle.
+ */
+template< typename T, typename CONV, std::size_t N >
+PG_TRIGONOMETRY_NODISCARD inline std::array< basic_angle< T, CONV >, N > normalized_abs( const std::array< basic_angle< T, CONV >, N > & angles ) noexcept
+{
+    auto result = angles;
+    for( std::size_t i = 0 ; i < N ; ++i )
+    {
+        result[ i ] = basic_angle< T, CONV >( detail::normalization::normalize_abs< T, CONV >( result[ i ].angle(), detail::normalization::is_exact< T, CONV >() ) );
+    }
+    return result;
+}
+
+/**
+ * \brief Normalizes a fixed size array of angle objects between 0 and 2 * semicircle.
+ */
+template< typename T, typename CONV, std::size_t N >
+inline void normalize_abs( std::array< basic_angle< T, CONV >, N > & angles ) noexcept
+{
+    angles = normalized_abs( angles );
+}
+
+/**
+ * \brief Converts a fixed size array of angle objects to another angle type.
+ *
+ * \tparam TO The angle type of the resulting array.
+ */
+template< typename TO, typename T, typename CONV, std::size_t N >
+PG_TRIGONOMETRY_NODISCARD inline std::array< TO, N > angle_cast( const std::array< basic_angle< T, CONV >, N > & angles ) noexcept
+{
+    std::array< TO, N > result;
+    for( std::size_t i = 0 ; i < N ; ++i )
+    {
+        result[ i ] = angle_cast< TO >( angles[ i ] );
+    }
+    return result;
+}
+
+}
+
+}
@@ -0,0 +1,261 @@
+// See LICENSE for the Copyright Notice
+
+#pragma once
+
+#include "trigonometry.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace pg
+{
+
+namespace math
+{
+
+/**
+ * \brief A neighbour found by \em circular_index; the index into the array the index was built from and the angular distance.
+ */
+template< typename ANGLE >
+struct angular_neighbour
+{
+    std::size_t index;
+    ANGLE       distance;
+};
+
+template< typename ANGLE >
+class circular_index;
+
+/**
+ * \brief A static index over an array of angles for nearest and k-nearest neighbour queries with wraparound distance.
+ *
+ * The angles are normalized between 0 and 2 * semicircle and sorted. A copy of the sorted angles in Eytzinger
+ * (breadth-first) order is searched for the first angle that is not less than the query; the top levels of that
+ * layout share a few cache lines and the search is branchless. The neighbours are then gathered by walking
+ * both ways from that position in the sorted order, wrapping around the end of the circle.
+ *
+ * The distance is the smallest angle between two angles, between 0 and semicircle.
+ */
+template< typename T, typename CONV >
+class circular_index< basic_angle< T, CONV > >
+{
+public:
+
+    using angle_type     = basic_angle< T, CONV >;
+    using neighbour_type = angular_neighbour< angle_type >;
+
+    circular_index() = default;
+
+    /**
+     * \brief Builds the index over an array of angles.
+     *
+     * \param angles Pointer to the angle objects.
+     * \param count  The number of angle objects.
+     */
+    circular_index( const angle_type * angles, std::size_t count )
+        : values( count )
+        , ids( count )
+        , eytzinger( count + 1 )
+        , ranks( count + 1 )
+    {
+        std::vector< T > normalized( count );
+        for( std::size_t i = 0 ; i < count ; ++i )
+        {
+            normalized[ i ] = angles[ i ].normalized_abs().angle();
+        }
+
+        std::iota( ids.begin(), ids.end(), std::size_t( 0 ) );
+        std::stable_sort( ids.begin(), ids.end(), [ & ]( std::size_t a, std::size_t b ) { return normalized[ a ] < normalized[ b ]; } );
+        for( std::size_t i = 0 ; i < count ; ++i )
+        {
+            values[ i ] = normalized[ ids[ i ] ];
+        }
+
+        std::size_t rank = 0;
+        build( 1, rank );
+    }
+
+    PG_TRIGONOMETRY_NODISCARD std::size_t size() const noexcept
+    {
+        return values.size();
+    }
+
+    PG_TRIGONOMETRY_NODISCARD bool empty() const noexcept
+    {
+        return values.empty();
+    }
+
+    /**
+     * \brief Returns the nearest angle.
+     *
+     * When the index is empty the neighbour has the index \em size() and an infinite distance,
+     * or the maximum value for integral angles.
+     */
+    PG_TRIGONOMETRY_NODISCARD neighbour_type nearest( angle_type angle ) const noexcept
+    {
+        if( values.empty() )
+        {
+            return missing();
+        }
+
+        const auto value = angle.normalized_abs().angle();
+        const auto next  = lower_bound( value );
+        const auto right = next == values.size() ? 0 : next;
+        const auto left  = ( next == 0 ? values.size() : next ) - 1;
+
+        const auto right_distance = distance( value, values[ right ] );
+        const auto left_distance  = distance( value, values[ left ] );
+        return left_distance < right_distance ? neighbour_type{ ids[ left ], angle_type( left_distance ) } :
+                                                neighbour_type{ ids[ right ], angle_type( right_distance ) };
+    }
+
+    /**
+     * \brief Finds the \em k nearest angles, nearest first.
+     *
+     * \param angle  The query angle.
+     * \param k      The number of neighbours.
+     * \param result Pointer to the array that receives \em k neighbours; when the index has fewer than \em k
+     *               angles the remaining entries receive the index \em size() and an infinite distance,
+     *               or the maximum value for integral angles.
+     */
+    void nearest( angle_type angle, std::size_t k, neighbour_type * result ) const noexcept
+    {
+        const auto found = std::min( k, values.size() );
+        if( found )
+        {
+            const auto value = angle.normalized_abs().angle();
+            const auto next  = lower_bound( value );
+
+            // Walk both ways from the insertion point; taking at most size() angles never visits one twice
+            auto right = next == values.size() ? 0 : next;
+            auto left  = ( next == 0 ? values.size() : next ) - 1;
+            for( std::size_t i = 0 ; i < found ; ++i )
+            {
+                const auto right_distance = distance( value, values[ right ] );
+                const auto left_distance  = distance( value, values[ left ] );
+                if( left_distance < right_distance )
+                {
+                    result[ i ] = { ids[ left ], angle_type( left_distance ) };
+                    left        = ( left == 0 ? values.size() : left ) - 1;
+                }
+                else
+                {
+                    result[ i ] = { ids[ right ], angle_type( right_distance ) };
+                    right       = right + 1 == values.size() ? 0 : right + 1;
+                }
+            }
+        }
+
+        std::fill( result + found, result + k, missing() );
+    }
+
+    /**
+     * \brief Returns the \em k nearest angles, nearest first.
+     *
+     * When the index has fewer than \em k angles only \em size() neighbours are returned.
+     */
+    PG_TRIGONOMETRY_NODISCARD std::vector< neighbour_type > nearest( angle_type angle, std::size_t k ) const
+    {
+        std::vector< neighbour_type > result( k );
+        nearest( angle, k, result.data() );
+        result.resize( std::min( k, values.size() ) );
+        return result;
+    }
+
+    /**
+     * \brief Finds the nearest angle for each angle of an array.
+     *
+     * \param angles Pointer to the query angles.
+     * \param count  The number of query angles.
+     * \param result Pointer to the array that receives \em count neighbours.
+     */
+    void nearest( const angle_type * angles, std::size_t count, neighbour_type * result ) const noexcept
+    {
+        for( std::size_t i = 0 ; i < count ; ++i )
+        {
+            result[ i ] = nearest( angles[ i ] );
+        }
+    }
+
+    /**
+     * \brief Finds the \em k nearest angles for each angle of an array.
+     *
+     * \param angles Pointer to the query angles.
+     * \param count  The number of query angles.
+     * \param k      The number of neighbours per query angle.
+     * \param result Pointer to the row-major \em count x \em k matrix that receives the neighbours, nearest first.
+     */
+    void nearest( const angle_type * angles, std::size_t count, std::size_t k, neighbour_type * result ) const noexcept
+    {
+        for( std::size_t i = 0 ; i < count ; ++i )
+        {
+            nearest( angles[ i ], k, result + i * k );
+        }
+    }
+
+private:
+
+    constexpr static T full_circle() noexcept
+    {
+        return static_cast< T >( CONV::semicircle * 2 );
+    }
+
+    constexpr static T far() noexcept
+    {
+        return std::numeric_limits< T >::has_infinity ? std::numeric_limits< T >::infinity() : std::numeric_limits< T >::max();
+    }
+
+    neighbour_type missing() const noexcept
+    {
+        return { values.size(), angle_type( far() ) };
+    }
+
+    static T distance( T a, T b ) noexcept
+    {
+        const auto d = static_cast< T >( a < b ? b - a : a - b );
+        return std::min( d, static_cast< T >( full_circle() - d ) );
+    }
+
+    // Fills the Eytzinger layout by an in-order walk of the implicit tree
+    void build( std::size_t node, std::size_t & rank )
+    {
+        if( node < eytzinger.size() )
+        {
+            build( 2 * node, rank );
+            eytzinger[ node ] = values[ rank ];
+            ranks[ node ]     = rank++;
+            build( 2 * node + 1, rank );
+        }
+    }
+
+    // The position in the sorted order of the first angle that is not less than the value, or size()
+    std::size_t lower_bound( T value ) const noexcept
+    {
+        std::size_t node = 1;
+        while( node < eytzinger.size() )
+        {
+            node = 2 * node + ( eytzinger[ node ] < value );
+        }
+
+        // The answer is the last node where the search went left; strip the trailing right turns and that left turn
+        while( node & 1 )
+        {
+            node >>= 1;
+        }
+        node >>= 1;
+
+        return node ? ranks[ node ] : values.size();
+    }
+
+    std::vector< T >           values;    // Sorted normalized angles
+    std::vector< std::size_t > ids;       // The index of each sorted angle in the original array
+    std::vector< T >           eytzinger; // The sorted angles in breadth-first order from element 1
+    std::vector< std::size_t > ranks;     // The position in the sorted order of each element of eytzinger
+};
+
+}
+
+}
@@ -0,0 +1,333 @@
+// See LICENSE for the Copyright Notice
+
+#pragma once
+
+#include "trigonometry.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+// The iterations are forced inline, the inlining heuristics of the compilers stop short of the unrolled rotations
+#if defined( _MSC_VER )
+# define PG_TRIGONOMETRY_FORCE_INLINE __forceinline
+#elif defined( __GNUC__ )
+# define PG_TRIGONOMETRY_FORCE_INLINE inline __attribute__(( always_inline ))
+#else
+# define PG_TRIGONOMETRY_FORCE_INLINE inline
+#endif
+
+namespace pg
+{
+
+namespace math
+{
+
+/**
+ * \brief The fixed-point value of 1 of the sines and cosines of the CORDIC functions; they have 30 fraction bits.
+ */
+constexpr std::int32_t cordic_unit = std::int32_t( 1 ) << 30;
+
+/**
+ * \brief The default number of CORDIC iterations; each iteration adds about one bit of precision.
+ */
+constexpr unsigned cordic_default_iterations = 24;
+
+namespace detail
+{
+
+namespace cordic
+{
+
+// atan( 2^-i ) in 2^32 units of a full circle
+constexpr std::uint32_t atan_table[] =
+{
+    536870912, 316933406, 167458907, 85004756, 42667331, 21354465, 10679838, 5340245,
+    2670163, 1335087, 667544, 333772, 166886, 83443, 41722, 20861,
+    10430, 5215, 2608, 1304, 652, 326, 163, 81,
+    41, 20, 10, 5, 3, 1, 1
+};
+
+// The inverse of the gain of n iterations, the product of 1 / sqrt( 1 + 2^-2i ) for i < n, with 30 fraction bits
+constexpr std::int32_t inverse_gain_table[] =
+{
+    1073741824, 759250125, 679093957, 658817909, 653730436, 652457347, 652138997, 652059405,
+    652039507, 652034532, 652033289, 652032978, 652032900, 652032881, 652032876, 652032874,
+    652032874, 652032874, 652032874, 652032874, 652032874, 652032874, 652032874, 652032874,
+    652032874, 652032874, 652032874, 652032874, 652032874, 652032874, 652032874
+};
+
+constexpr std::uint32_t half_turn = 0x80000000u;
+
+template< unsigned N >
+struct check_iterations
+{
+    static_assert( N >= 1 && N <= 30, "The number of CORDIC iterations must be between 1 and 30" );
+};
+
+template< typename CONV >
+constexpr std::uint64_t full_circle() noexcept
+{
+    return static_cast< std::uint64_t >( CONV::semicircle * 2.0L );
+}
+
+template< typename T, typename CONV >
+struct check_angle_type
+{
+    static_assert( normalization::is_exact< T, CONV >::value, "CORDIC requires an integral angle type with a whole number of units in a full circle" );
+    static_assert( full_circle< CONV >() >= 2 && full_circle< CONV >() <= ( std::uint64_t( 1 ) << 32 ), "The full circle must be between 2 and 2^32 units" );
+};
+
+// The angle in 2^32 units of a full circle; multiplying by ceil( 2^64 / full circle ) keeps whole fractions of the circle exact
+template< typename T, typename CONV >
+PG_TRIGONOMETRY_FORCE_INLINE std::uint32_t to_turn( T value ) noexcept
+{
+    using work = normalization::work_t< T, CONV >;
+
+    constexpr auto full  = full_circle< CONV >();
+    constexpr auto scale = std::numeric_limits< std::uint64_t >::max() / full + 1;
+
+    auto remainder = normalization::remainder< T, CONV >( value );
+    remainder      = static_cast< work >( remainder < 0 ? remainder + static_cast< work >( full ) : remainder );
+    return static_cast< std::uint32_t >( ( static_cast< std::uint64_t >( remainder ) * scale ) >> 32 );
+}
+
+// Converts an arc tangent in 2^32 units of a full circle to the nearest value in the unit of TO.
+// The sign is that of y, as for std::atan2, so that an angle near the semicircle does not flip sign with the rounding.
+template< typename TO >
+inline TO from_turn( std::uint32_t turn, bool negative ) noexcept
+{
+    using value_type = typename TO::value_type;
+
+    constexpr auto full = static_cast< std::int64_t >( full_circle< typename TO::conversion >() );
+    const auto     signed_turn = turn >= half_turn ? static_cast< std::int64_t >( turn ) - ( std::int64_t( 1 ) << 32 ) : static_cast< std::int64_t >( turn );
+
+    // Rounded to nearest with the ties up; the product fits because the full circle is at most 2^32
+    const auto value     = ( signed_turn * full + ( std::int64_t( 1 ) << 31 ) ) >> 32;
+    const auto magnitude = value < 0 ? -value : value;
+    return TO( static_cast< value_type >( negative ? -magnitude : magnitude ) );
+}
+
+// The rotation mode iterations I up to N, unrolled at compile time so that a loop over angles is vectorizable.
+// The iterations rely on arithmetic right shifts of negative values, as do all supported compilers.
+template< unsigned I, unsigned N >
+struct rotate
+{
+    PG_TRIGONOMETRY_FORCE_INLINE static void apply( std::int32_t & x, std::int32_t & y, std::int32_t & z ) noexcept
+    {
+        constexpr auto a = static_cast< std::int32_t >( atan_table[ I ] );
+
+        const auto dx = y >> I;
+        const auto dy = x >> I;
+        const auto up = z >= 0;
+        x = up ? x - dx : x + dx;
+        y = up ? y + dy : y - dy;
+        z = up ? z - a : z + a;
+        rotate< I + 1, N >::apply( x, y, z );
+    }
+};
+
+template< unsigned N >
+struct rotate< N, N >
+{
+    PG_TRIGONOMETRY_FORCE_INLINE static void apply( std::int32_t &, std::int32_t &, std::int32_t & ) noexcept
+    {
+    }
+};
+
+// Rotation mode; rotates ( 1 / gain, 0 ) over the angle in 2^32 units of a full circle
+template< unsigned N >
+PG_TRIGONOMETRY_FORCE_INLINE void sincos( std::uint32_t turn, std::int32_t & sin_result, std::int32_t & cos_result ) noexcept
+{
+    // The nearest quarter circle and the remainder within -/+ 1/8 of a circle; the sum wraps to quadrant 0 near a full circle
+    const auto quadrant = ( turn + 0x20000000u ) >> 30;
+    const auto rest     = turn - ( quadrant << 30 );
+    auto       z        = static_cast< std::int32_t >( rest >= half_turn ? static_cast< std::int64_t >( rest ) - ( std::int64_t( 1 ) << 32 ) : rest );
+
+    std::int32_t x = inverse_gain_table[ N ];
+    std::int32_t y = 0;
+    rotate< 0, N >::apply( x, y, z );
+
+    cos_result = quadrant == 0 ? x : quadrant == 1 ? -y : quadrant == 2 ? -x : y;
+    sin_result = quadrant == 0 ? y : quadrant == 1 ? x : quadrant == 2 ? -y : -x;
+}
+
+// Vectoring mode; rotates ( x, y ) onto the positive x axis and accumulates the angle in 2^32 units of a full circle.
+// The inputs are scaled by 2^30 into 64 bits so that small integers keep their precision; x receives gain * magnitude * 2^30.
+template< unsigned N >
+inline std::uint32_t vector( std::int64_t & x, std::int64_t & y ) noexcept
+{
+    const auto left = x < 0;
+    x = left ? -x : x;
+    y = left ? -y : y;
+    std::uint32_t z = left ? half_turn : 0u;
+
+    for( unsigned i = 0 ; i < N ; ++i )
+    {
+        const auto dx   = y >> i;
+        const auto dy   = x >> i;
+        const auto a    = atan_table[ i ];
+        const auto down = y >= 0;
+        x = down ? x + dx : x - dx;
+        y = down ? y - dy : y + dy;
+        z = down ? z + a : z - a;
+    }
+    return z;
+}
+
+template< typename T >
+inline std::int64_t scaled( T value ) noexcept
+{
+    static_assert( std::is_integral< T >::value && sizeof( T ) <= 4, "CORDIC vectoring requires integral values of at most 32 bits" );
+    return static_cast< std::int64_t >( value ) * cordic_unit;
+}
+
+// Removes the gain and the 2^30 scale of the x of vectoring mode, rounded to nearest, without overflowing 64 bits
+template< unsigned N >
+inline std::uint64_t magnitude( std::int64_t x ) noexcept
+{
+    const auto value = static_cast< std::uint64_t >( x );
+    const auto gain  = static_cast< std::uint64_t >( inverse_gain_table[ N ] );
+    const auto high  = ( value >> 32 ) * gain;
+    const auto low   = ( ( value & 0xFFFFFFFFu ) * gain ) >> 32;
+    return ( high + low + ( std::uint64_t( 1 ) << 27 ) ) >> 28;
+}
+
+}
+
+}
+
+/**
+ * \brief Computes the sine and cosine of an integral angle with integer CORDIC iterations.
+ *
+ * The angle is converted exactly to 2^32 units of a full circle and only integer additions and shifts are used, so the
+ * results are the same on all platforms. The results are fixed-point values with 30 fraction bits, see \em cordic_unit.
+ * The absolute error is about 2^-N for N iterations.
+ *
+ * \tparam N The number of iterations, between 1 and 30.
+ */
+template< unsigned N = cordic_default_iterations, typename T, typename CONV >
+inline void cordic_sincos( basic_angle< T, CONV > x, std::int32_t & sin_result, std::int32_t & cos_result ) noexcept
+{
+    static_cast< void >( detail::cordic::check_iterations< N >() );
+    static_cast< void >( detail::cordic::check_angle_type< T, CONV >() );
+
+    detail::cordic::sincos< N >( detail::cordic::to_turn< T, CONV >( x.angle() ), sin_result, cos_result );
+}
+
+/**
+ * \brief Computes the sine of an integral angle with integer CORDIC iterations; see \em cordic_sincos.
+ */
+template< unsigned N = cordic_default_iterations, typename T, typename CONV >
+PG_TRIGONOMETRY_NODISCARD inline std::int32_t cordic_sin( basic_angle< T, CONV > x ) noexcept
+{
+    std::int32_t s;
+    std::int32_t c;
+    cordic_sincos< N >( x, s, c );
+    return s;
+}
+
+/**
+ * \brief Computes the cosine of an integral angle with integer CORDIC iterations; see \em cordic_sincos.
+ */
+template< unsigned N = cordic_default_iterations, typename T, typename CONV >
+PG_TRIGONOMETRY_NODISCARD inline std::int32_t cordic_cos( basic_angle< T, CONV > x ) noexcept
+{
+    std::int32_t s;
+    std::int32_t c;
+    cordic_sincos< N >( x, s, c );
+    return c;
+}
+
+/**
+ * \brief Computes the sines and cosines of an array of integral angles with integer CORDIC iterations; see \em cordic_sincos.
+ *
+ * The iterations work on 32 bit lanes and are forced inline, so that compilers vectorize the loop (GCC 12 at -O3 does).
+ *
+ * \param x          Pointer to the angle objects.
+ * \param count      The number of angle objects.
+ * \param sin_result Pointer to the array that receives \em count sines with 30 fraction bits.
+ * \param cos_result Pointer to the array that receives \em count cosines with 30 fraction bits.
+ */
+template< unsigned N = cordic_default_iterations, typename T, typename CONV >
+inline void cordic_sincos( const basic_angle< T, CONV > * x, std::size_t count, std::int32_t * sin_result, std::int32_t * cos_result ) noexcept
+{
+    static_cast< void >( detail::cordic::check_iterations< N >() );
+    static_cast< void >( detail::cordic::check_angle_type< T, CONV >() );
+
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        detail::cordic::sincos< N >( detail::cordic::to_turn< T, CONV >( x[ i ].angle() ), sin_result[ i ], cos_result[ i ] );
+    }
+}
+
+/**
+ * \brief Computes the arc tangent of y/x with integer CORDIC iterations, using the signs to determine the quadrant.
+ *
+ * The result is rounded to the nearest value of the integral angle type \em TO between -/+ semicircle and is the same on all platforms.
+ * The arc tangent of (0, 0) is 0.
+ *
+ * \tparam TO The resulting integral angle type.
+ * \tparam N  The number of iterations, between 1 and 30.
+ *
+ * \param y Integral value of at most 32 bits.
+ * \param x Integral value of at most 32 bits.
+ */
+template< typename TO, unsigned N = cordic_default_iterations, typename T1, typename T2 >
+PG_TRIGONOMETRY_NODISCARD inline TO cordic_atan2( T1 y, T2 x ) noexcept
+{
+    static_cast< void >( detail::cordic::check_iterations< N >() );
+    static_cast< void >( detail::cordic::check_angle_type< typename TO::value_type, typename TO::conversion >() );
+
+    auto       vx   = detail::cordic::scaled( x );
+    auto       vy   = detail::cordic::scaled( y );
+    const auto zero = vx == 0 && vy == 0;
+    const auto turn = detail::cordic::vector< N >( vx, vy );
+    return detail::cordic::from_turn< TO >( zero ? 0u : turn, y < 0 );
+}
+
+/**
+ * \brief Computes the magnitude sqrt( x^2 + y^2 ) of a vector with integer CORDIC iterations, rounded to nearest.
+ *
+ * The relative error is about 2^-N for N iterations.
+ *
+ * \tparam N The number of iterations, between 1 and 30.
+ *
+ * \param x Integral value of at most 32 bits.
+ * \param y Integral value of at most 32 bits.
+ */
+template< unsigned N = cordic_default_iterations, typename T1, typename T2 >
+PG_TRIGONOMETRY_NODISCARD inline std::uint64_t cordic_magnitude( T1 x, T2 y ) noexcept
+{
+    static_cast< void >( detail::cordic::check_iterations< N >() );
+
+    auto vx = detail::cordic::scaled( x );
+    auto vy = detail::cordic::scaled( y );
+    static_cast< void >( detail::cordic::vector< N >( vx, vy ) );
+    return detail::cordic::magnitude< N >( vx );
+}
+
+/**
+ * \brief Computes the arc tangents of y/x for arrays of integral values with integer CORDIC iterations; see \em cordic_atan2.
+ *
+ * Unlike \em cordic_sincos the iterations work on 64 bit lanes, the 32 bit inputs are scaled by 2^30 to keep the precision
+ * of small values, so the loop runs at the scalar speed on most targets.
+ *
+ * \param y      Pointer to the \em y values.
+ * \param x      Pointer to the \em x values.
+ * \param count  The number of values in \em y and \em x.
+ * \param result Pointer to the array that receives \em count arc tangents.
+ */
+template< typename TO, unsigned N = cordic_default_iterations, typename T1, typename T2 >
+inline void cordic_atan2( const T1 * y, const T2 * x, std::size_t count, TO * result ) noexcept
+{
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        result[ i ] = cordic_atan2< TO, N >( y[ i ], x[ i ] );
+    }
+}
+
+}
+
+}
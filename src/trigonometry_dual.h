@@ -0,0 +1,358 @@
+// See LICENSE for the Copyright Notice
+
+#pragma once
+
+#include "trigonometry.h"
+#include "trigonometry_batch.h"
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+namespace pg
+{
+
+namespace math
+{
+
+/**
+ * \brief A dual number, a value with its derivative with respect to one parameter.
+ *
+ * Used as the value type of an angle, e.g. \em dual_deg, the trigonometric functions return the value and the derivative
+ * from one evaluation of the sine and cosine, with the chain rule of the unit of the angle applied.
+ * The comparison operators compare the values.
+ */
+template< typename T >
+struct dual
+{
+    using value_type = T;
+
+    T value      = T();
+    T derivative = T();
+
+    constexpr dual() = default;
+
+    constexpr dual( T value, T derivative = T() )
+        : value( value )
+        , derivative( derivative )
+    {}
+
+    constexpr dual & operator +=( dual other ) noexcept
+    {
+        value      += other.value;
+        derivative += other.derivative;
+        return *this;
+    }
+
+    constexpr dual & operator -=( dual other ) noexcept
+    {
+        value      -= other.value;
+        derivative -= other.derivative;
+        return *this;
+    }
+
+    constexpr dual & operator *=( dual other ) noexcept
+    {
+        derivative = derivative * other.value + value * other.derivative;
+        value     *= other.value;
+        return *this;
+    }
+
+    constexpr dual & operator /=( dual other ) noexcept
+    {
+        derivative = ( derivative * other.value - value * other.derivative ) / ( other.value * other.value );
+        value     /= other.value;
+        return *this;
+    }
+};
+
+using dual_deg  = basic_angle< dual< double >, deg_conv >;
+using dual_rad  = basic_angle< dual< double >, rad_conv >;
+using dual_grad = basic_angle< dual< double >, grad_conv >;
+
+namespace detail
+{
+
+namespace derivative
+{
+
+template< typename S >
+using if_scalar = typename std::enable_if< std::is_arithmetic< S >::value >::type;
+
+// The derivative of the radians of one unit of an angle type
+template< typename CONV >
+constexpr double radians_per_unit() noexcept
+{
+    return static_cast< double >( trig::pi_ld / CONV::semicircle );
+}
+
+template< typename CONV >
+inline void sincos( double x, double & sin_result, double & cos_result, precise ) noexcept
+{
+    // The values are those of sin and cos of angle objects, which compute in long double for units such as degrees
+    const auto angle = basic_angle< double, CONV >( x );
+    sin_result = static_cast< double >( trig::sin( angle, precise() ) );
+    cos_result = static_cast< double >( trig::cos( angle, precise() ) );
+}
+
+template< typename CONV, typename P >
+inline void sincos( double x, double & sin_result, double & cos_result, P policy ) noexcept
+{
+    if( !trig::sincos_kernel< CONV >( x, sin_result, cos_result, policy ) )
+    {
+        sincos< CONV >( x, sin_result, cos_result, precise() );
+    }
+}
+
+}
+
+}
+
+template< typename T >
+PG_TRIGONOMETRY_NODISCARD constexpr dual< T > operator -( dual< T > x ) noexcept
+{
+    return { -x.value, -x.derivative };
+}
+
+template< typename T >
+PG_TRIGONOMETRY_NODISCARD constexpr dual< T > operator +( dual< T > left, dual< T > right ) noexcept
+{
+    return left += right;
+}
+
+template< typename T >
+PG_TRIGONOMETRY_NODISCARD constexpr dual< T > operator -( dual< T > left, dual< T > right ) noexcept
+{
+    return left -= right;
+}
+
+template< typename T >
+PG_TRIGONOMETRY_NODISCARD constexpr dual< T > operator *( dual< T > left, dual< T > right ) noexcept
+{
+    return left *= right;
+}
+
+template< typename T >
+PG_TRIGONOMETRY_NODISCARD constexpr dual< T > operator /( dual< T > left, dual< T > right ) noexcept
+{
+    return left /= right;
+}
+
+template< typename T, typename S, typename = detail::derivative::if_scalar< S > >
+PG_TRIGONOMETRY_NODISCARD constexpr dual< T > operator +( dual< T > left, S right ) noexcept
+{
+    return { static_cast< T >( left.value + right ), left.derivative };
+}
+
+template< typename T, typename S, typename = detail::derivative::if_scalar< S > >
+PG_TRIGONOMETRY_NODISCARD constexpr dual< T > operator +( S left, dual< T > right ) noexcept
+{
+    return right + left;
+}
+
+template< typename T, typename S, typename = detail::derivative::if_scalar< S > >
+PG_TRIGONOMETRY_NODISCARD constexpr dual< T > operator -( dual< T > left, S right ) noexcept
+{
+    return { static_cast< T >( left.value - right ), left.derivative };
+}
+
+template< typename T, typename S, typename = detail::derivative::if_scalar< S > >
+PG_TRIGONOMETRY_NODISCARD constexpr dual< T > operator -( S left, dual< T > right ) noexcept
+{
+    return { static_cast< T >( left - right.value ), -right.derivative };
+}
+
+template< typename T, typename S, typename = detail::derivative::if_scalar< S > >
+PG_TRIGONOMETRY_NODISCARD constexpr dual< T > operator *( dual< T > left, S right ) noexcept
+{
+    return { static_cast< T >( left.value * right ), static_cast< T >( left.derivative * right ) };
+}
+
+template< typename T, typename S, typename = detail::derivative::if_scalar< S > >
+PG_TRIGONOMETRY_NODISCARD constexpr dual< T > operator *( S left, dual< T > right ) noexcept
+{
+    return right * left;
+}
+
+template< typename T, typename S, typename = detail::derivative::if_scalar< S > >
+PG_TRIGONOMETRY_NODISCARD constexpr dual< T > operator /( dual< T > left, S right ) noexcept
+{
+    return { static_cast< T >( left.value / right ), static_cast< T >( left.derivative / right ) };
+}
+
+template< typename T, typename S, typename = detail::derivative::if_scalar< S > >
+PG_TRIGONOMETRY_NODISCARD constexpr dual< T > operator /( S left, dual< T > right ) noexcept
+{
+    return dual< T >( static_cast< T >( left ) ) / right;
+}
+
+template< typename T >
+PG_TRIGONOMETRY_NODISCARD constexpr bool operator <( dual< T > left, dual< T > right ) noexcept
+{
+    return left.value < right.value;
+}
+
+template< typename T >
+PG_TRIGONOMETRY_NODISCARD constexpr bool operator <=( dual< T > left, dual< T > right ) noexcept
+{
+    return left.value <= right.value;
+}
+
+template< typename T >
+PG_TRIGONOMETRY_NODISCARD constexpr bool operator >( dual< T > left, dual< T > right ) noexcept
+{
+    return left.value > right.value;
+}
+
+template< typename T >
+PG_TRIGONOMETRY_NODISCARD constexpr bool operator >=( dual< T > left, dual< T > right ) noexcept
+{
+    return left.value >= right.value;
+}
+
+template< typename T >
+PG_TRIGONOMETRY_NODISCARD constexpr bool operator ==( dual< T > left, dual< T > right ) noexcept
+{
+    return left.value == right.value;
+}
+
+template< typename T >
+PG_TRIGONOMETRY_NODISCARD constexpr bool operator !=( dual< T > left, dual< T > right ) noexcept
+{
+    return left.value != right.value;
+}
+
+template< typename T >
+inline std::ostream & operator <<( std::ostream & os, dual< T > x )
+{
+    return os << x.value;
+}
+
+/**
+ * \brief Computes the sine of an angle and its derivative from one evaluation of the sine and cosine.
+ *
+ * The derivative is cos( x ) * d( radians ) / d( unit ) times the derivative of the angle, e.g. pi / 180 for degrees.
+ *
+ * \tparam P The precision policy; \em precise, \em fast or \em fastest.
+ *           Defaults to the \em precision of the conversion object of \em x when available, otherwise \em precise.
+ */
+template< typename P = void, typename T, typename CONV >
+PG_TRIGONOMETRY_NODISCARD inline dual< double > sin( basic_angle< dual< T >, CONV > x ) noexcept
+{
+    double s;
+    double c;
+    detail::derivative::sincos< CONV >( static_cast< double >( x.angle().value ), s, c, detail::trig::precision_t< P, CONV >() );
+    return { s, c * detail::derivative::radians_per_unit< CONV >() * static_cast< double >( x.angle().derivative ) };
+}
+
+/**
+ * \brief Computes the cosine of an angle and its derivative from one evaluation of the sine and cosine; see \em sin.
+ */
+template< typename P = void, typename T, typename CONV >
+PG_TRIGONOMETRY_NODISCARD inline dual< double > cos( basic_angle< dual< T >, CONV > x ) noexcept
+{
+    double s;
+    double c;
+    detail::derivative::sincos< CONV >( static_cast< double >( x.angle().value ), s, c, detail::trig::precision_t< P, CONV >() );
+    return { c, -s * detail::derivative::radians_per_unit< CONV >() * static_cast< double >( x.angle().derivative ) };
+}
+
+/**
+ * \brief Computes the tangent of an angle and its derivative from one evaluation of the sine and cosine; see \em sin.
+ */
+template< typename P = void, typename T, typename CONV >
+PG_TRIGONOMETRY_NODISCARD inline dual< double > tan( basic_angle< dual< T >, CONV > x ) noexcept
+{
+    double s;
+    double c;
+    detail::derivative::sincos< CONV >( static_cast< double >( x.angle().value ), s, c, detail::trig::precision_t< P, CONV >() );
+    return { s / c, detail::derivative::radians_per_unit< CONV >() * static_cast< double >( x.angle().derivative ) / ( c * c ) };
+}
+
+/**
+ * \brief Computes the sine and cosine of an angle and their derivatives from one evaluation; see \em sin.
+ */
+template< typename P = void, typename T, typename CONV >
+inline void sincos( basic_angle< dual< T >, CONV > x, dual< double > & sin_result, dual< double > & cos_result ) noexcept
+{
+    double s;
+    double c;
+    detail::derivative::sincos< CONV >( static_cast< double >( x.angle().value ), s, c, detail::trig::precision_t< P, CONV >() );
+
+    const auto d = detail::derivative::radians_per_unit< CONV >() * static_cast< double >( x.angle().derivative );
+    sin_result = { s, c * d };
+    cos_result = { c, -s * d };
+}
+
+/**
+ * \brief Computes the arc tangent of y/x and its derivative, using the signs to determine the quadrant.
+ *
+ * The derivative is ( x * dy - y * dx ) / ( x^2 + y^2 ) in the unit of \em TO.
+ *
+ * \tparam TO The resulting angle type with a dual value type, e.g. \em dual_deg.
+ * \tparam P  The precision policy of the value; \em precise, \em fast or \em fastest.
+ *            Defaults to the \em precision of the conversion object of \em TO when available, otherwise \em precise.
+ */
+template< typename TO = dual_rad, typename P = void, typename T >
+PG_TRIGONOMETRY_NODISCARD inline TO atan2( dual< T > y, dual< T > x ) noexcept
+{
+    using conversion = typename TO::conversion;
+    using value_type = typename TO::value_type::value_type;
+
+    const auto angle  = atan2< basic_angle< double, conversion >, P >( static_cast< double >( y.value ), static_cast< double >( x.value ) );
+    const auto radius = static_cast< double >( x.value ) * x.value + static_cast< double >( y.value ) * y.value;
+    const auto slope  = ( static_cast< double >( x.value ) * y.derivative - static_cast< double >( y.value ) * x.derivative ) / radius;
+    return TO( { static_cast< value_type >( angle.angle() ), static_cast< value_type >( slope / detail::derivative::radians_per_unit< conversion >() ) } );
+}
+
+/**
+ * \brief Computes the sines and cosines of an array of angle objects and their derivatives with respect to the angles.
+ *
+ * The derivatives are in the unit of the angles, e.g. cos( x ) * pi / 180 for degrees, and are the diagonals of the
+ * Jacobians of the sines and cosines. The loop is vectorizable like the batch \em sincos.
+ *
+ * \tparam P The precision policy; \em precise, \em fast or \em fastest.
+ *           Defaults to the \em precision of the conversion object when available, otherwise \em precise.
+ *
+ * \param x                 Pointer to the angle objects.
+ * \param count             The number of angle objects.
+ * \param sin_result        Pointer to the array that receives \em count sines.
+ * \param cos_result        Pointer to the array that receives \em count cosines.
+ * \param sin_derivative    Pointer to the array that receives \em count derivatives of the sines.
+ * \param cos_derivative    Pointer to the array that receives \em count derivatives of the cosines.
+ */
+template< typename P = void, typename T, typename CONV >
+inline void sincos_jacobian( const basic_angle< T, CONV > * x, std::size_t count, double * sin_result, double * cos_result,
+                             double * sin_derivative, double * cos_derivative ) noexcept
+{
+    constexpr auto scale = detail::derivative::radians_per_unit< CONV >();
+
+    detail::batch::sincos_loop( x, count, detail::trig::precision_t< P, CONV >(), [ = ]( std::size_t i, double s, double c )
+    {
+        sin_result[ i ]     = s;
+        cos_result[ i ]     = c;
+        sin_derivative[ i ] = c * scale;
+        cos_derivative[ i ] = -s * scale;
+    } );
+}
+
+/**
+ * \brief Computes the sines and cosines of an array of angle objects with dual values, with their derivatives; see \em sin.
+ *
+ * \param x          Pointer to the angle objects.
+ * \param count      The number of angle objects.
+ * \param sin_result Pointer to the array that receives \em count sines.
+ * \param cos_result Pointer to the array that receives \em count cosines.
+ */
+template< typename P = void, typename T, typename CONV >
+inline void sincos( const basic_angle< dual< T >, CONV > * x, std::size_t count, dual< double > * sin_result, dual< double > * cos_result ) noexcept
+{
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        sincos< P >( x[ i ], sin_result[ i ], cos_result[ i ] );
+    }
+}
+
+}
+
+}
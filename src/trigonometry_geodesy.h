@@ -0,0 +1,491 @@
+// See LICENSE for the Copyright Notice
+
+#pragma once
+
+#include "trigonometry.h"
+#include "trigonometry_batch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace pg
+{
+
+namespace math
+{
+
+/**
+ * \brief The mean radius of the earth in meters.
+ */
+constexpr double mean_earth_radius = 6371008.8;
+
+/**
+ * \brief A pair of points within a query distance.
+ */
+struct distance_match
+{
+    std::size_t index;
+    std::size_t other_index;
+    double      distance;
+};
+
+namespace detail
+{
+
+namespace geodesy
+{
+
+// Number of rows and columns of a tile of the distance matrix; the columns of a tile fit in the L1 cache
+constexpr std::size_t tile_rows    = 16;
+constexpr std::size_t tile_columns = 512;
+
+// Number of elements of the stack buffers of the pairwise functions
+constexpr std::size_t block_size = 256;
+
+// Points on the unit sphere
+struct unit_vectors
+{
+    std::vector< double > x;
+    std::vector< double > y;
+    std::vector< double > z;
+};
+
+template< typename P, typename T, typename CONV >
+inline unit_vectors make_unit_vectors( const basic_angle< T, CONV > * latitude, const basic_angle< T, CONV > * longitude, std::size_t count )
+{
+    unit_vectors v = { std::vector< double >( count ), std::vector< double >( count ), std::vector< double >( count ) };
+    std::vector< double > cos_latitude( count );
+
+    sincos< P >( latitude, count, v.z.data(), cos_latitude.data() );
+    sincos< P >( longitude, count, v.y.data(), v.x.data() );
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        v.x[ i ] *= cos_latitude[ i ];
+        v.y[ i ] *= cos_latitude[ i ];
+    }
+
+    return v;
+}
+
+// Squared chord lengths between point i of a and the points [begin, end) of b
+inline void squared_chords( const unit_vectors & a, std::size_t i, const unit_vectors & b, std::size_t begin, std::size_t end, double * result ) noexcept
+{
+    const auto   x  = a.x[ i ];
+    const auto   y  = a.y[ i ];
+    const auto   z  = a.z[ i ];
+    const auto * bx = b.x.data();
+    const auto * by = b.y.data();
+    const auto * bz = b.z.data();
+    for( std::size_t j = begin ; j < end ; ++j )
+    {
+        const auto dx = x - bx[ j ];
+        const auto dy = y - by[ j ];
+        const auto dz = z - bz[ j ];
+        result[ j - begin ] = dx * dx + dy * dy + dz * dz;
+    }
+}
+
+// The haversine of the central angle is a quarter of the squared chord, which avoids the
+// cancellation of the spherical law of cosines for nearby points.
+template< typename P >
+inline double distance( double squared_chord, double radius, P policy ) noexcept
+{
+    auto h = 0.5 * std::sqrt( squared_chord );
+    h = h < 1.0 ? h : 1.0;
+    return trig::atan2_kernel( h, std::sqrt( ( 1.0 - h ) * ( 1.0 + h ) ), 2.0 * radius * trig::pi, policy );
+}
+
+inline double squared_chord( double distance, double radius ) noexcept
+{
+    const auto half_angle = distance / ( 2.0 * radius );
+    if( half_angle >= trig::pi / 2.0 )
+    {
+        return std::numeric_limits< double >::infinity();
+    }
+
+    const auto chord = 2.0 * std::sin( half_angle );
+    return chord * chord;
+}
+
+// Wraps values between -/+ semicircle like basic_angle::normalize
+inline double wrap( double value, double semicircle ) noexcept
+{
+    return value - 2.0 * semicircle * std::floor( ( value + semicircle ) / ( 2.0 * semicircle ) );
+}
+
+// Moves the results of atan2 between -/+ semicircle to between 0 and 2 * semicircle like basic_angle::normalize_abs
+template< typename TO >
+inline void wrap_abs( TO * angles, std::size_t count ) noexcept
+{
+    using value_type = typename TO::value_type;
+    constexpr auto full = static_cast< value_type >( TO::conversion::semicircle * 2 );
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        auto value = angles[ i ].angle();
+        value = value < value_type() ? static_cast< value_type >( value + full ) : value;
+        value = value < full ? value : value_type();
+        angles[ i ] = { value };
+    }
+}
+
+// Runs task( 0 ) ... task( tasks - 1 ) on up to \em threads threads; 0 uses all hardware threads.
+template< typename F >
+inline void parallel_for( std::size_t tasks, unsigned threads, F task )
+{
+    if( !threads )
+    {
+        threads = std::max( 1u, std::thread::hardware_concurrency() );
+    }
+    threads = static_cast< unsigned >( std::min< std::size_t >( threads, tasks ) );
+
+    std::atomic< std::size_t > next( 0 );
+    const auto worker = [ & ]()
+    {
+        for( auto t = next.fetch_add( 1, std::memory_order_relaxed ) ; t < tasks ; t = next.fetch_add( 1, std::memory_order_relaxed ) )
+        {
+            task( t );
+        }
+    };
+
+    std::vector< std::thread > pool;
+    for( unsigned t = 1 ; t < threads ; ++t )
+    {
+        pool.emplace_back( worker );
+    }
+    worker();
+    for( auto & thread : pool )
+    {
+        thread.join();
+    }
+}
+
+}
+
+}
+
+/**
+ * \brief Computes the great-circle distances between two sets of points.
+ *
+ * The sine and cosine of each latitude and longitude are computed once. The matrix is filled in tiles
+ * that are distributed over the threads and the distances of a tile row are computed by a vectorizable loop.
+ *
+ * \tparam P The precision policy; \em precise, \em fast or \em fastest.
+ *
+ * \param latitude        Pointer to the latitudes of the first set of points.
+ * \param longitude       Pointer to the longitudes of the first set of points.
+ * \param count           The number of points in the first set.
+ * \param other_latitude  Pointer to the latitudes of the second set of points.
+ * \param other_longitude Pointer to the longitudes of the second set of points.
+ * \param other_count     The number of points in the second set.
+ * \param result          Pointer to the row-major \em count x \em other_count matrix that receives the distances.
+ * \param radius          The radius of the sphere; the distances have the same unit.
+ * \param threads         The maximum number of threads; 0 uses all hardware threads.
+ */
+template< typename P = void, typename T, typename CONV >
+inline void distance_matrix( const basic_angle< T, CONV > * latitude, const basic_angle< T, CONV > * longitude, std::size_t count,
+                             const basic_angle< T, CONV > * other_latitude, const basic_angle< T, CONV > * other_longitude, std::size_t other_count,
+                             double * result, double radius = mean_earth_radius, unsigned threads = 0 )
+{
+    using namespace detail::geodesy;
+
+    const auto policy = detail::trig::precision_t< P, CONV >();
+    const auto a      = make_unit_vectors< P >( latitude, longitude, count );
+    const auto b      = make_unit_vectors< P >( other_latitude, other_longitude, other_count );
+
+    const auto row_tiles    = ( count + tile_rows - 1 ) / tile_rows;
+    const auto column_tiles = ( other_count + tile_columns - 1 ) / tile_columns;
+
+    parallel_for( row_tiles * column_tiles, threads, [ & ]( std::size_t tile )
+    {
+        const auto row_begin    = tile / column_tiles * tile_rows;
+        const auto row_end      = std::min( row_begin + tile_rows, count );
+        const auto column_begin = tile % column_tiles * tile_columns;
+        const auto column_end   = std::min( column_begin + tile_columns, other_count );
+
+        for( auto i = row_begin ; i < row_end ; ++i )
+        {
+            auto * row = result + i * other_count + column_begin;
+            squared_chords( a, i, b, column_begin, column_end, row );
+            for( std::size_t j = 0 ; j < column_end - column_begin ; ++j )
+            {
+                row[ j ] = distance( row[ j ], radius, policy );
+            }
+        }
+    } );
+}
+
+/**
+ * \brief Finds the \em k nearest points of the second set for each point of the first set.
+ *
+ * The candidates are ranked by their chord length so that only the \em k nearest are converted to distances.
+ * When the second set has fewer than \em k points the remaining entries receive the index \em other_count
+ * and an infinite distance.
+ *
+ * \tparam P The precision policy; \em precise, \em fast or \em fastest.
+ *
+ * \param latitude        Pointer to the latitudes of the first set of points.
+ * \param longitude       Pointer to the longitudes of the first set of points.
+ * \param count           The number of points in the first set.
+ * \param other_latitude  Pointer to the latitudes of the second set of points.
+ * \param other_longitude Pointer to the longitudes of the second set of points.
+ * \param other_count     The number of points in the second set.
+ * \param k               The number of nearest points per point of the first set.
+ * \param indices         Pointer to the row-major \em count x \em k matrix that receives the indices into the second set, nearest first.
+ * \param distances       Pointer to the row-major \em count x \em k matrix that receives the distances.
+ * \param radius          The radius of the sphere; the distances have the same unit.
+ * \param threads         The maximum number of threads; 0 uses all hardware threads.
+ */
+template< typename P = void, typename T, typename CONV >
+inline void nearest( const basic_angle< T, CONV > * latitude, const basic_angle< T, CONV > * longitude, std::size_t count,
+                     const basic_angle< T, CONV > * other_latitude, const basic_angle< T, CONV > * other_longitude, std::size_t other_count,
+                     std::size_t k, std::size_t * indices, double * distances, double radius = mean_earth_radius, unsigned threads = 0 )
+{
+    using namespace detail::geodesy;
+
+    const auto policy = detail::trig::precision_t< P, CONV >();
+    const auto a      = make_unit_vectors< P >( latitude, longitude, count );
+    const auto b      = make_unit_vectors< P >( other_latitude, other_longitude, other_count );
+
+    parallel_for( ( count + tile_rows - 1 ) / tile_rows, threads, [ & ]( std::size_t tile )
+    {
+        double chords[ tile_columns ];
+        std::vector< std::pair< double, std::size_t > > heap;
+        heap.reserve( k );
+
+        const auto row_end = std::min( tile * tile_rows + tile_rows, count );
+        for( auto i = tile * tile_rows ; i < row_end ; ++i )
+        {
+            heap.clear();
+            for( std::size_t column = 0 ; column < other_count && k ; column += tile_columns )
+            {
+                const auto column_end = std::min( column + tile_columns, other_count );
+                squared_chords( a, i, b, column, column_end, chords );
+                for( auto j = column ; j < column_end ; ++j )
+                {
+                    const auto candidate = std::make_pair( chords[ j - column ], j );
+                    if( heap.size() < k )
+                    {
+                        heap.push_back( candidate );
+                        std::push_heap( heap.begin(), heap.end() );
+                    }
+                    else if( candidate < heap.front() )
+                    {
+                        std::pop_heap( heap.begin(), heap.end() );
+                        heap.back() = candidate;
+                        std::push_heap( heap.begin(), heap.end() );
+                    }
+                }
+            }
+            std::sort_heap( heap.begin(), heap.end() );
+
+            for( std::size_t n = 0 ; n < k ; ++n )
+            {
+                const auto found = n < heap.size();
+                indices[ i * k + n ]   = found ? heap[ n ].second : other_count;
+                distances[ i * k + n ] = found ? distance( heap[ n ].first, radius, policy ) : std::numeric_limits< double >::infinity();
+            }
+        }
+    } );
+}
+
+/**
+ * \brief Finds all pairs of points of the two sets that are within a distance.
+ *
+ * The distance is converted to a chord length once so that the candidates are tested without trigonometric functions.
+ *
+ * \tparam P The precision policy; \em precise, \em fast or \em fastest.
+ *
+ * \param latitude        Pointer to the latitudes of the first set of points.
+ * \param longitude       Pointer to the longitudes of the first set of points.
+ * \param count           The number of points in the first set.
+ * \param other_latitude  Pointer to the latitudes of the second set of points.
+ * \param other_longitude Pointer to the longitudes of the second set of points.
+ * \param other_count     The number of points in the second set.
+ * \param max_distance    The maximum distance of a pair, inclusive.
+ * \param radius          The radius of the sphere; the distances have the same unit.
+ * \param threads         The maximum number of threads; 0 uses all hardware threads.
+ *
+ * \return The pairs ordered by the index of the first set and then by the index of the second set.
+ */
+template< typename P = void, typename T, typename CONV >
+PG_TRIGONOMETRY_NODISCARD inline std::vector< distance_match > within_distance( const basic_angle< T, CONV > * latitude, const basic_angle< T, CONV > * longitude, std::size_t count,
+                                                                                const basic_angle< T, CONV > * other_latitude, const basic_angle< T, CONV > * other_longitude, std::size_t other_count,
+                                                                                double max_distance, double radius = mean_earth_radius, unsigned threads = 0 )
+{
+    using namespace detail::geodesy;
+
+    const auto policy    = detail::trig::precision_t< P, CONV >();
+    const auto a         = make_unit_vectors< P >( latitude, longitude, count );
+    const auto b         = make_unit_vectors< P >( other_latitude, other_longitude, other_count );
+    const auto threshold = squared_chord( max_distance, radius );
+
+    std::vector< std::vector< distance_match > > tiles( ( count + tile_rows - 1 ) / tile_rows );
+    parallel_for( tiles.size(), threads, [ & ]( std::size_t tile )
+    {
+        double chords[ tile_columns ];
+
+        const auto row_end = std::min( tile * tile_rows + tile_rows, count );
+        for( auto i = tile * tile_rows ; i < row_end ; ++i )
+        {
+            for( std::size_t column = 0 ; column < other_count ; column += tile_columns )
+            {
+                const auto column_end = std::min( column + tile_columns, other_count );
+                squared_chords( a, i, b, column, column_end, chords );
+                for( auto j = column ; j < column_end ; ++j )
+                {
+                    if( chords[ j - column ] <= threshold )
+                    {
+                        tiles[ tile ].push_back( { i, j, distance( chords[ j - column ], radius, policy ) } );
+                    }
+                }
+            }
+        }
+    } );
+
+    std::vector< distance_match > matches;
+    for( const auto & tile : tiles )
+    {
+        matches.insert( matches.end(), tile.begin(), tile.end() );
+    }
+
+    return matches;
+}
+
+/**
+ * \brief Computes the initial bearings of the great circles from points to other points.
+ *
+ * The bearings are measured clockwise from north and are between 0 and a full circle like \em normalize_abs.
+ * The sines and cosines of the coordinates and the arc tangents are computed with the batch functions in blocks.
+ *
+ * \tparam TO The angle type of the bearings.
+ * \tparam P  The precision policy; \em precise, \em fast or \em fastest.
+ *
+ * \param latitude        Pointer to the latitudes of the start points.
+ * \param longitude       Pointer to the longitudes of the start points.
+ * \param other_latitude  Pointer to the latitudes of the end points.
+ * \param other_longitude Pointer to the longitudes of the end points.
+ * \param count           The number of pairs of points.
+ * \param result          Pointer to the array that receives \em count bearings.
+ */
+template< typename TO = rad, typename P = void, typename T, typename CONV >
+inline void initial_bearing( const basic_angle< T, CONV > * latitude, const basic_angle< T, CONV > * longitude,
+                             const basic_angle< T, CONV > * other_latitude, const basic_angle< T, CONV > * other_longitude,
+                             std::size_t count, TO * result ) noexcept
+{
+    using detail::geodesy::block_size;
+
+    double sin_latitude[ block_size ];
+    double cos_latitude[ block_size ];
+    double sin_other_latitude[ block_size ];
+    double cos_other_latitude[ block_size ];
+    double y[ block_size ];
+    double x[ block_size ];
+    double sin_other_longitude[ block_size ];
+    double cos_other_longitude[ block_size ];
+
+    for( std::size_t offset = 0 ; offset < count ; offset += block_size )
+    {
+        const auto n = std::min( block_size, count - offset );
+        sincos< P >( latitude + offset, n, sin_latitude, cos_latitude );
+        sincos< P >( other_latitude + offset, n, sin_other_latitude, cos_other_latitude );
+        sincos< P >( longitude + offset, n, y, x );
+        sincos< P >( other_longitude + offset, n, sin_other_longitude, cos_other_longitude );
+
+        for( std::size_t i = 0 ; i < n ; ++i )
+        {
+            const auto sin_delta = sin_other_longitude[ i ] * x[ i ] - cos_other_longitude[ i ] * y[ i ];
+            const auto cos_delta = cos_other_longitude[ i ] * x[ i ] + sin_other_longitude[ i ] * y[ i ];
+
+            y[ i ] = sin_delta * cos_other_latitude[ i ];
+            x[ i ] = cos_latitude[ i ] * sin_other_latitude[ i ] - sin_latitude[ i ] * cos_other_latitude[ i ] * cos_delta;
+        }
+
+        atan2< TO, P >( y, x, n, result + offset );
+        detail::geodesy::wrap_abs( result + offset, n );
+    }
+}
+
+/**
+ * \brief Computes the destination points of travelling along great circles.
+ *
+ * The longitudes of the destinations are between -/+ a semicircle like \em normalize.
+ * The sines and cosines, the arc sines and the arc tangents are computed with the batch functions in blocks.
+ * The angular distances are evaluated in the unit of the start points and with their precision policy.
+ *
+ * \tparam TO The angle type of the coordinates of the destinations.
+ * \tparam P  The precision policy; \em precise, \em fast or \em fastest.
+ *
+ * \param latitude         Pointer to the latitudes of the start points.
+ * \param longitude        Pointer to the longitudes of the start points.
+ * \param bearing          Pointer to the initial bearings, clockwise from north.
+ * \param distance         Pointer to the distances.
+ * \param count            The number of start points.
+ * \param result_latitude  Pointer to the array that receives \em count latitudes.
+ * \param result_longitude Pointer to the array that receives \em count longitudes.
+ * \param radius           The radius of the sphere in the unit of the distances.
+ */
+template< typename TO = rad, typename P = void, typename T, typename CONV, typename BEARING_T, typename BEARING_CONV >
+inline void destination( const basic_angle< T, CONV > * latitude, const basic_angle< T, CONV > * longitude,
+                         const basic_angle< BEARING_T, BEARING_CONV > * bearing, const double * distance,
+                         std::size_t count, TO * result_latitude, TO * result_longitude, double radius = mean_earth_radius ) noexcept
+{
+    using detail::geodesy::block_size;
+    using delta_angle    = basic_angle< double, typename TO::conversion >;
+    using distance_angle = basic_angle< double, CONV >;
+
+    constexpr auto semicircle = detail::batch::semicircle< TO >();
+    constexpr auto scale      = static_cast< double >( static_cast< long double >( TO::conversion::semicircle ) / CONV::semicircle );
+    constexpr auto to_unit    = static_cast< double >( CONV::semicircle / static_cast< long double >( detail::trig::pi ) );
+
+    double         sin_latitude[ block_size ];
+    double         cos_latitude[ block_size ];
+    double         sin_bearing[ block_size ];
+    double         cos_bearing[ block_size ];
+    double         sin_distance[ block_size ];
+    double         cos_distance[ block_size ];
+    distance_angle angular_distance[ block_size ];
+    delta_angle    delta[ block_size ];
+
+    for( std::size_t offset = 0 ; offset < count ; offset += block_size )
+    {
+        const auto n = std::min( block_size, count - offset );
+        // The angular distances are in the unit of the start points, so that they are evaluated with the same precision policy
+        for( std::size_t i = 0 ; i < n ; ++i )
+        {
+            angular_distance[ i ] = distance_angle( distance[ offset + i ] / radius * to_unit );
+        }
+        sincos< P >( latitude + offset, n, sin_latitude, cos_latitude );
+        sincos< P >( bearing + offset, n, sin_bearing, cos_bearing );
+        sincos< P >( angular_distance, n, sin_distance, cos_distance );
+
+        // The sine of the latitude of the destination replaces the sine of the bearing after its last use
+        for( std::size_t i = 0 ; i < n ; ++i )
+        {
+            const auto sin_result = sin_latitude[ i ] * cos_distance[ i ] + cos_latitude[ i ] * sin_distance[ i ] * cos_bearing[ i ];
+            const auto y          = sin_bearing[ i ] * sin_distance[ i ] * cos_latitude[ i ];
+
+            sin_bearing[ i ]  = std::min( 1.0, std::max( -1.0, sin_result ) );
+            cos_bearing[ i ]  = cos_distance[ i ] - sin_latitude[ i ] * sin_bearing[ i ];
+            sin_distance[ i ] = y;
+        }
+
+        asin< TO, P >( sin_bearing, n, result_latitude + offset );
+        atan2< delta_angle, P >( sin_distance, cos_bearing, n, delta );
+
+        for( std::size_t i = 0 ; i < n ; ++i )
+        {
+            const auto value = static_cast< double >( longitude[ offset + i ].angle() ) * scale + delta[ i ].angle();
+            result_longitude[ offset + i ] = detail::batch::make_angle< TO >( detail::geodesy::wrap( value, semicircle ) );
+        }
+    }
+}
+
+}
+
+}
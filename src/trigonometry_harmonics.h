@@ -0,0 +1,190 @@
+// See LICENSE for the Copyright Notice
+
+#pragma once
+
+#include "trigonometry.h"
+#include "trigonometry_batch.h"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace pg
+{
+
+namespace math
+{
+
+namespace detail
+{
+
+namespace harmonic
+{
+
+// The number of samples of a Fourier series that are evaluated together, one per vector lane
+constexpr std::size_t lanes = 8;
+
+template< typename T, typename CONV, typename P >
+inline void first( basic_angle< T, CONV > x, double & sin_result, double & cos_result, P policy ) noexcept
+{
+    batch::sincos_loop( &x, 1, policy, [ & ]( std::size_t, double s, double c )
+    {
+        sin_result = s;
+        cos_result = c;
+    } );
+}
+
+/*
+ * The harmonics follow from the angle addition formulas, a rotation by the first harmonic in the complex plane:
+ * cos( ( k + 1 ) x ) = cos( k x ) cos( x ) - sin( k x ) sin( x ) and sin( ( k + 1 ) x ) = sin( k x ) cos( x ) + cos( k x ) sin( x ).
+ * Unlike the three-term Chebyshev recurrence the rounding errors only grow linearly with k, also near 0 and semicircle.
+ */
+inline void rotate( double & s, double & c, double s1, double c1 ) noexcept
+{
+    const auto next_c = c * c1 - s * s1;
+    const auto next_s = s * c1 + c * s1;
+    c = next_c;
+    s = next_s;
+}
+
+}
+
+}
+
+/**
+ * \brief Computes the sines and cosines of the harmonics k * x of an angle object for k = 1 ... \em count.
+ *
+ * Only the first harmonic is evaluated; the others follow from a complex rotation recurrence with errors that grow
+ * linearly with k, about k times the error of the first harmonic.
+ *
+ * \tparam P The precision policy of the first harmonic; \em precise, \em fast or \em fastest.
+ *           Defaults to the \em precision of the conversion object of \em x when available, otherwise \em precise.
+ *
+ * \param x          An angle object.
+ * \param count      The number of harmonics.
+ * \param sin_result Pointer to the array that receives sin( k * x ) for k = 1 ... \em count.
+ * \param cos_result Pointer to the array that receives cos( k * x ) for k = 1 ... \em count.
+ */
+template< typename P = void, typename T, typename CONV >
+inline void harmonics( basic_angle< T, CONV > x, std::size_t count, double * sin_result, double * cos_result ) noexcept
+{
+    double s1;
+    double c1;
+    detail::harmonic::first( x, s1, c1, detail::trig::precision_t< P, CONV >() );
+
+    auto s = s1;
+    auto c = c1;
+    for( std::size_t k = 0 ; k < count ; ++k )
+    {
+        sin_result[ k ] = s;
+        cos_result[ k ] = c;
+        detail::harmonic::rotate( s, c, s1, c1 );
+    }
+}
+
+/**
+ * \brief Computes the sines and cosines of the harmonics k * x for k = 1 ... \em harmonics_count of each angle object of an array.
+ *
+ * \param x               Pointer to the angle objects.
+ * \param count           The number of angle objects.
+ * \param harmonics_count The number of harmonics per angle object.
+ * \param sin_result      Pointer to the row-major \em count x \em harmonics_count matrix that receives the sines.
+ * \param cos_result      Pointer to the row-major \em count x \em harmonics_count matrix that receives the cosines.
+ */
+template< typename P = void, typename T, typename CONV >
+inline void harmonics( const basic_angle< T, CONV > * x, std::size_t count, std::size_t harmonics_count, double * sin_result, double * cos_result ) noexcept
+{
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        harmonics< P >( x[ i ], harmonics_count, sin_result + i * harmonics_count, cos_result + i * harmonics_count );
+    }
+}
+
+/**
+ * \brief Evaluates the Fourier series sum of a[ k - 1 ] * cos( k * x ) + b[ k - 1 ] * sin( k * x ) for k = 1 ... \em count.
+ *
+ * The constant term is not included. The harmonics are computed with the recurrence of \em harmonics.
+ *
+ * \param x                 An angle object.
+ * \param cos_coefficients  Pointer to the \em count coefficients a of the cosines.
+ * \param sin_coefficients  Pointer to the \em count coefficients b of the sines.
+ * \param count             The number of harmonics.
+ */
+template< typename P = void, typename T, typename CONV >
+PG_TRIGONOMETRY_NODISCARD inline double fourier_series( basic_angle< T, CONV > x, const double * cos_coefficients, const double * sin_coefficients,
+                                                        std::size_t count ) noexcept
+{
+    double s1;
+    double c1;
+    detail::harmonic::first( x, s1, c1, detail::trig::precision_t< P, CONV >() );
+
+    auto s   = s1;
+    auto c   = c1;
+    auto sum = 0.0;
+    for( std::size_t k = 0 ; k < count ; ++k )
+    {
+        sum += cos_coefficients[ k ] * c + sin_coefficients[ k ] * s;
+        detail::harmonic::rotate( s, c, s1, c1 );
+    }
+    return sum;
+}
+
+/**
+ * \brief Evaluates a Fourier series for each angle object of an array; see \em fourier_series.
+ *
+ * The samples are evaluated in groups of 8 with one sample per vector lane, so that the recurrence over the
+ * harmonics is vectorized across the samples and the coefficients are read once per group.
+ *
+ * \param x                 Pointer to the angle objects.
+ * \param count             The number of angle objects.
+ * \param cos_coefficients  Pointer to the \em harmonics_count coefficients a of the cosines.
+ * \param sin_coefficients  Pointer to the \em harmonics_count coefficients b of the sines.
+ * \param harmonics_count   The number of harmonics.
+ * \param result            Pointer to the array that receives \em count sums.
+ */
+template< typename P = void, typename T, typename CONV >
+inline void fourier_series( const basic_angle< T, CONV > * x, std::size_t count, const double * cos_coefficients, const double * sin_coefficients,
+                            std::size_t harmonics_count, double * result ) noexcept
+{
+    using detail::harmonic::lanes;
+
+    for( std::size_t first = 0 ; first < count ; first += lanes )
+    {
+        const auto n = std::min( lanes, count - first );
+
+        // Unused lanes rotate by 0
+        double s1[ lanes ] = {};
+        double c1[ lanes ] = { 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0 };
+        detail::batch::sincos_loop( x + first, n, detail::trig::precision_t< P, CONV >(), [ & ]( std::size_t i, double s, double c )
+        {
+            s1[ i ] = s;
+            c1[ i ] = c;
+        } );
+
+        double s[ lanes ];
+        double c[ lanes ];
+        double sum[ lanes ];
+        for( std::size_t i = 0 ; i < lanes ; ++i )
+        {
+            s[ i ]   = s1[ i ];
+            c[ i ]   = c1[ i ];
+            sum[ i ] = 0.0;
+        }
+
+        for( std::size_t k = 0 ; k < harmonics_count ; ++k )
+        {
+            const auto a = cos_coefficients[ k ];
+            const auto b = sin_coefficients[ k ];
+            for( std::size_t i = 0 ; i < lanes ; ++i )
+            {
+                sum[ i ] += a * c[ i ] + b * s[ i ];
+                detail::harmonic::rotate( s[ i ], c[ i ], s1[ i ], c1[ i ] );
+            }
+        }
+
+        std::copy( sum, sum + n, result + first );
+    }
+}
+
+}
+
+}
@@ -0,0 +1,374 @@
+// See LICENSE for the Copyright Notice
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace pg
+{
+
+namespace math
+{
+
+namespace instrumentation
+{
+
+/**
+ * \brief The functions that report their calls when PG_TRIGONOMETRY_INSTRUMENTATION is defined.
+ */
+enum class probe : std::size_t
+{
+    normalize,
+    normalize_abs,
+    angle_cast,
+    sin,
+    cos,
+    tan
+};
+
+constexpr std::size_t probe_count = 6;
+
+/**
+ * \brief Number of input magnitude bins for each probe and angle type.
+ *
+ * The bins are based on the absolute value of the input expressed in semicircles;
+ * <= 1, <= 2, <= 2^8, <= 2^16, <= 2^25, > 2^25 and non-finite.
+ * Inputs above 2^25 semicircles (~1.05e8 radians) take the slow large-argument reduction path of glibc's libm.
+ */
+constexpr std::size_t magnitude_bins = 7;
+
+/**
+ * \brief Maximum number of distinct angle types that are tracked separately.
+ *
+ * The last slot collects the calls of all angle types that did not fit.
+ */
+constexpr std::size_t max_angle_types = 16;
+
+/**
+ * \brief The aggregated counters of one probe and angle type.
+ */
+struct snapshot_entry
+{
+    probe                                          function;
+    std::string                                    angle_type;
+    std::uint64_t                                  calls;
+    std::array< std::uint64_t, magnitude_bins >    histogram;
+};
+
+namespace detail
+{
+
+struct thread_counters
+{
+    thread_counters() noexcept
+    {
+        for( auto & p : histogram )
+        {
+            for( auto & t : p )
+            {
+                for( auto & b : t )
+                {
+                    b.store( 0, std::memory_order_relaxed );
+                }
+            }
+        }
+        in_use.store( false, std::memory_order_relaxed );
+    }
+
+    std::atomic< std::uint64_t > histogram[ probe_count ][ max_angle_types ][ magnitude_bins ];
+    std::atomic< bool >          in_use;
+    thread_counters *            next = nullptr;
+};
+
+inline std::atomic< thread_counters * > & thread_list() noexcept
+{
+    static std::atomic< thread_counters * > head( nullptr );
+    return head;
+}
+
+// Counters of threads that have exited are handed over to new threads; they are never freed
+// so that a snapshot can walk the list without synchronizing with the threads that record.
+inline thread_counters * claim_counters()
+{
+    auto & head = thread_list();
+    for( auto c = head.load( std::memory_order_acquire ) ; c ; c = c->next )
+    {
+        bool expected = false;
+        if( c->in_use.compare_exchange_strong( expected, true, std::memory_order_acquire ) )
+        {
+            return c;
+        }
+    }
+
+    auto c = new thread_counters();
+    c->in_use.store( true, std::memory_order_relaxed );
+    c->next = head.load( std::memory_order_relaxed );
+    while( !head.compare_exchange_weak( c->next, c, std::memory_order_release, std::memory_order_relaxed ) )
+    {}
+
+    return c;
+}
+
+struct thread_handle
+{
+    thread_handle()
+        : counters( claim_counters() )
+    {}
+
+    ~thread_handle()
+    {
+        counters->in_use.store( false, std::memory_order_release );
+    }
+
+    thread_counters * const counters;
+};
+
+inline thread_counters & local_counters()
+{
+    thread_local thread_handle handle;
+    return *handle.counters;
+}
+
+struct angle_type_slot
+{
+    std::atomic< bool > ready;
+    char                name[ 32 ];
+};
+
+inline angle_type_slot * angle_type_slots() noexcept
+{
+    static angle_type_slot slots[ max_angle_types ] = {};
+    return slots;
+}
+
+// The number of slots that are handed out to angle types
+inline std::atomic< std::size_t > & angle_type_reservations() noexcept
+{
+    static std::atomic< std::size_t > count( 0 );
+    return count;
+}
+
+// The number of slots that are ready; a snapshot reads no other slots
+inline std::atomic< std::size_t > & angle_type_count() noexcept
+{
+    static std::atomic< std::size_t > count( 0 );
+    return count;
+}
+
+inline std::size_t register_angle_type( const char * value_type, long double semicircle ) noexcept
+{
+    const auto index = std::min( angle_type_reservations().fetch_add( 1, std::memory_order_relaxed ), max_angle_types - 1 );
+    if( index < max_angle_types - 1 )
+    {
+        auto & slot = angle_type_slots()[ index ];
+        std::snprintf( slot.name, sizeof( slot.name ), "%s@%Lg", value_type, semicircle );
+        slot.ready.store( true, std::memory_order_release );
+    }
+
+    // The slots are published in the order of their indices and only after they are ready, so the count never covers
+    // a slot of which a concurrent registration is still writing the name
+    auto & count = angle_type_count();
+    for( auto published = count.load( std::memory_order_relaxed ) ; published <= index ; published = count.load( std::memory_order_relaxed ) )
+    {
+        if( published == index && count.compare_exchange_weak( published, index + 1, std::memory_order_release, std::memory_order_relaxed ) )
+        {
+            break;
+        }
+        std::this_thread::yield();
+    }
+
+    return index;
+}
+
+template< typename T >
+const char * value_type_name() noexcept
+{
+    if( std::is_floating_point< T >::value )
+    {
+        return sizeof( T ) == 4 ? "f32" : sizeof( T ) == 8 ? "f64" : "f80";
+    }
+    if( std::is_integral< T >::value )
+    {
+        static const char * const names[ 2 ][ 4 ] = { { "u8", "u16", "u32", "u64" }, { "i8", "i16", "i32", "i64" } };
+        const auto size = sizeof( T ) == 1 ? 0 : sizeof( T ) == 2 ? 1 : sizeof( T ) == 4 ? 2 : 3;
+        return names[ std::is_signed< T >::value ][ size ];
+    }
+    return "other";
+}
+
+template< typename ANGLE >
+std::size_t angle_type_index() noexcept
+{
+    static const std::size_t index = register_angle_type( value_type_name< typename ANGLE::value_type >(),
+                                                          static_cast< long double >( ANGLE::conversion::semicircle ) );
+    return index;
+}
+
+inline std::size_t magnitude_bin( long double semicircles ) noexcept
+{
+    const auto magnitude = std::fabs( semicircles );
+    if( !( magnitude <= std::numeric_limits< long double >::max() ) )
+    {
+        return 6;
+    }
+
+    return magnitude <= 1.0L ? 0 :
+           magnitude <= 2.0L ? 1 :
+           magnitude <= 256.0L ? 2 :
+           magnitude <= 65536.0L ? 3 :
+           magnitude <= 33554432.0L ? 4 : 5;
+}
+
+/**
+ * \brief Counts a call of \em function with \em angle as input for the current thread.
+ *
+ * The counters are only written by their own thread so an increment is a plain load and store.
+ */
+template< typename ANGLE >
+void record( probe function, ANGLE angle ) noexcept
+{
+    const auto semicircles = static_cast< long double >( angle.angle() ) / ANGLE::conversion::semicircle;
+    auto & counter = local_counters().histogram[ static_cast< std::size_t >( function ) ]
+                                               [ angle_type_index< ANGLE >() ]
+                                               [ magnitude_bin( semicircles ) ];
+    counter.store( counter.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+}
+
+/**
+ * \brief Counts a call of a constexpr function that cannot be constant evaluated for \em angle; see \em record.
+ *
+ * Used before C++20 when constant evaluation cannot be detected, so that the exact normalizations stay constexpr.
+ */
+template< typename ANGLE >
+void record_runtime( probe function, ANGLE angle, std::false_type /* is_exact */ ) noexcept
+{
+    record( function, angle );
+}
+
+template< typename ANGLE >
+constexpr void record_runtime( probe, ANGLE, std::true_type /* is_exact */ ) noexcept
+{}
+
+}
+
+/**
+ * \brief Returns the name of a probe.
+ */
+inline const char * probe_name( probe function ) noexcept
+{
+    static const char * const names[ probe_count ] = { "normalize", "normalize_abs", "angle_cast", "sin", "cos", "tan" };
+    return names[ static_cast< std::size_t >( function ) ];
+}
+
+/**
+ * \brief Returns the label of a magnitude bin.
+ */
+inline const char * magnitude_label( std::size_t bin ) noexcept
+{
+    static const char * const labels[ magnitude_bins ] = { "<=1", "<=2", "<=2^8", "<=2^16", "<=2^25", ">2^25", "non-finite" };
+    return labels[ bin ];
+}
+
+/**
+ * \brief Aggregates the counters of all threads.
+ *
+ * This function can be called from any thread and does not block the threads that record calls.
+ * Counters that are updated concurrently may or may not be included.
+ *
+ * \return The counters of each probe and angle type that has been called at least once.
+ */
+inline std::vector< snapshot_entry > take_snapshot()
+{
+    const auto type_count = detail::angle_type_count().load( std::memory_order_acquire );
+
+    std::vector< snapshot_entry > entries;
+    for( std::size_t p = 0 ; p < probe_count ; ++p )
+    {
+        for( std::size_t t = 0 ; t < type_count ; ++t )
+        {
+            snapshot_entry entry = { static_cast< probe >( p ), std::string(), 0, {} };
+            for( auto c = detail::thread_list().load( std::memory_order_acquire ) ; c ; c = c->next )
+            {
+                for( std::size_t b = 0 ; b < magnitude_bins ; ++b )
+                {
+                    const auto count = c->histogram[ p ][ t ][ b ].load( std::memory_order_relaxed );
+                    entry.histogram[ b ] += count;
+                    entry.calls          += count;
+                }
+            }
+
+            if( entry.calls )
+            {
+                const auto & slot = detail::angle_type_slots()[ t ];
+                if( t == max_angle_types - 1 )
+                {
+                    entry.angle_type = "other";
+                }
+                else if( slot.ready.load( std::memory_order_acquire ) )
+                {
+                    entry.angle_type = slot.name;
+                }
+                entries.push_back( std::move( entry ) );
+            }
+        }
+    }
+
+    return entries;
+}
+
+/**
+ * \brief Writes a snapshot as plain text with one line for each probe and angle type.
+ */
+inline std::ostream & write_text( std::ostream & os, const std::vector< snapshot_entry > & entries )
+{
+    for( const auto & entry : entries )
+    {
+        os << probe_name( entry.function ) << ' ' << entry.angle_type << " calls=" << entry.calls;
+        for( std::size_t b = 0 ; b < magnitude_bins ; ++b )
+        {
+            os << ' ' << magnitude_label( b ) << '=' << entry.histogram[ b ];
+        }
+        os << '\n';
+    }
+
+    return os;
+}
+
+/**
+ * \brief Writes a snapshot as a JSON array with an object for each probe and angle type.
+ */
+inline std::ostream & write_json( std::ostream & os, const std::vector< snapshot_entry > & entries )
+{
+    os << '[';
+    for( std::size_t i = 0 ; i < entries.size() ; ++i )
+    {
+        const auto & entry = entries[ i ];
+        os << ( i ? "," : "" ) << "{\"function\":\"" << probe_name( entry.function )
+           << "\",\"angle_type\":\"" << entry.angle_type
+           << "\",\"calls\":" << entry.calls << ",\"histogram\":{";
+        for( std::size_t b = 0 ; b < magnitude_bins ; ++b )
+        {
+            os << ( b ? "," : "" ) << '"' << magnitude_label( b ) << "\":" << entry.histogram[ b ];
+        }
+        os << "}}";
+    }
+
+    return os << ']';
+}
+
+}
+
+}
+
+}
@@ -0,0 +1,333 @@
+// See LICENSE for the Copyright Notice
+
+#pragma once
+
+#include "trigonometry.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <vector>
+
+namespace pg
+{
+
+namespace math
+{
+
+/**
+ * \brief An interval of angles that runs counter-clockwise from \em first up to, but not including, \em last.
+ *
+ * The interval may cross the 0 / full circle boundary, e.g. 330° to 30°.
+ * An interval with the same normalized \em first and \em last covers the full circle.
+ */
+template< typename ANGLE >
+struct angular_interval
+{
+    ANGLE first;
+    ANGLE last;
+};
+
+template< typename ANGLE >
+class angular_interval_set;
+
+/**
+ * \brief A set of angular intervals with fast queries for the intervals that contain an angle.
+ *
+ * The intervals are split where they cross the 0 / full circle boundary and the circle is divided at all the
+ * endpoints into segments that are covered by the same intervals. The segment boundaries are kept in a sorted
+ * flat array and the intervals that cover each segment in a second flat array, so that a query is a
+ * branchless binary search of O(log K) followed by a walk over the matching intervals.
+ *
+ * The intervals are identified by their insertion index. Inserting intervals rebuilds the index; insert
+ * a range of intervals at once when there are many. Queries are const and can be run from multiple threads.
+ */
+template< typename T, typename CONV >
+class angular_interval_set< basic_angle< T, CONV > >
+{
+public:
+
+    using angle_type    = basic_angle< T, CONV >;
+    using interval_type = angular_interval< angle_type >;
+
+    angular_interval_set()
+        : boundaries( 1, T() )
+        , offsets( 2, 0 )
+    {
+    }
+
+    angular_interval_set( std::initializer_list< interval_type > intervals )
+        : angular_interval_set()
+    {
+        insert( intervals.begin(), intervals.end() );
+    }
+
+    template< typename IT >
+    angular_interval_set( IT begin, IT end )
+        : angular_interval_set()
+    {
+        insert( begin, end );
+    }
+
+    /**
+     * \brief Adds an interval to the set.
+     *
+     * \return The index of the interval.
+     */
+    std::size_t insert( angle_type first, angle_type last )
+    {
+        intervals.push_back( { first, last } );
+        rebuild();
+        return intervals.size() - 1;
+    }
+
+    /**
+     * \brief Adds a range of intervals to the set and rebuilds the index once.
+     */
+    template< typename IT >
+    void insert( IT begin, IT end )
+    {
+        intervals.insert( intervals.end(), begin, end );
+        rebuild();
+    }
+
+    /**
+     * \brief Removes all the intervals.
+     */
+    void clear()
+    {
+        intervals.clear();
+        rebuild();
+    }
+
+    PG_TRIGONOMETRY_NODISCARD std::size_t size() const noexcept
+    {
+        return intervals.size();
+    }
+
+    PG_TRIGONOMETRY_NODISCARD bool empty() const noexcept
+    {
+        return intervals.empty();
+    }
+
+    PG_TRIGONOMETRY_NODISCARD const interval_type & operator []( std::size_t index ) const noexcept
+    {
+        return intervals[ index ];
+    }
+
+    /**
+     * \brief Calls \em f with the index of each interval that contains the angle, in ascending order.
+     */
+    template< typename F >
+    void for_each_containing( angle_type angle, F f ) const
+    {
+        const auto s = segment( angle );
+        for( auto i = offsets[ s ] ; i < offsets[ s + 1 ] ; ++i )
+        {
+            f( ids[ i ] );
+        }
+    }
+
+    /**
+     * \brief Returns the indices of the intervals that contain the angle in ascending order.
+     */
+    PG_TRIGONOMETRY_NODISCARD std::vector< std::size_t > containing( angle_type angle ) const
+    {
+        const auto s = segment( angle );
+        return std::vector< std::size_t >( ids.begin() + offsets[ s ], ids.begin() + offsets[ s + 1 ] );
+    }
+
+    /**
+     * \brief Returns the number of intervals that contain the angle.
+     */
+    PG_TRIGONOMETRY_NODISCARD std::size_t count_containing( angle_type angle ) const noexcept
+    {
+        const auto s = segment( angle );
+        return offsets[ s + 1 ] - offsets[ s ];
+    }
+
+    /**
+     * \brief Returns true when any interval contains the angle.
+     */
+    PG_TRIGONOMETRY_NODISCARD bool contains( angle_type angle ) const noexcept
+    {
+        return count_containing( angle ) != 0;
+    }
+
+    /**
+     * \brief Returns the indices of the intervals that overlap the interval from \em first up to \em last, in ascending order.
+     */
+    PG_TRIGONOMETRY_NODISCARD std::vector< std::size_t > overlapping( angle_type first, angle_type last ) const
+    {
+        std::vector< std::size_t > result;
+        split( first, last, [ & ]( T begin, T end )
+        {
+            // The segments that start before the end of the piece and end after its begin
+            const auto b = segment( angle_type( begin ) );
+            const auto e = static_cast< std::size_t >( std::lower_bound( boundaries.begin(), boundaries.end(), end ) - boundaries.begin() );
+            result.insert( result.end(), ids.begin() + offsets[ b ], ids.begin() + offsets[ e ] );
+        } );
+
+        std::sort( result.begin(), result.end() );
+        result.erase( std::unique( result.begin(), result.end() ), result.end() );
+        return result;
+    }
+
+    /**
+     * \brief Calls \em f with the position in the array and the index of the interval for each angle and interval that contains it.
+     *
+     * \param angles Pointer to the angle objects.
+     * \param count  The number of angle objects.
+     * \param f      Called as f( position, interval index ).
+     */
+    template< typename F >
+    void for_each_containing( const angle_type * angles, std::size_t count, F f ) const
+    {
+        for( std::size_t a = 0 ; a < count ; ++a )
+        {
+            const auto s = segment( angles[ a ] );
+            for( auto i = offsets[ s ] ; i < offsets[ s + 1 ] ; ++i )
+            {
+                f( a, ids[ i ] );
+            }
+        }
+    }
+
+    /**
+     * \brief Computes the number of intervals that contain each angle of an array.
+     *
+     * \param angles Pointer to the angle objects.
+     * \param count  The number of angle objects.
+     * \param result Pointer to the array that receives \em count numbers of intervals.
+     */
+    void count_containing( const angle_type * angles, std::size_t count, std::size_t * result ) const noexcept
+    {
+        for( std::size_t a = 0 ; a < count ; ++a )
+        {
+            result[ a ] = count_containing( angles[ a ] );
+        }
+    }
+
+    /**
+     * \brief Computes for each angle of an array whether any interval contains it.
+     *
+     * \param angles Pointer to the angle objects.
+     * \param count  The number of angle objects.
+     * \param result Pointer to the array that receives \em count results.
+     */
+    void contains( const angle_type * angles, std::size_t count, bool * result ) const noexcept
+    {
+        for( std::size_t a = 0 ; a < count ; ++a )
+        {
+            result[ a ] = contains( angles[ a ] );
+        }
+    }
+
+private:
+
+    constexpr static T full_circle() noexcept
+    {
+        return static_cast< T >( CONV::semicircle * 2 );
+    }
+
+    // Calls f with the pieces [begin, end) between 0 and the full circle of an interval
+    template< typename F >
+    static void split( angle_type first, angle_type last, F f )
+    {
+        const auto begin = first.normalized_abs().angle();
+        const auto end   = last.normalized_abs().angle();
+        if( begin < end )
+        {
+            f( begin, end );
+        }
+        else
+        {
+            f( begin, full_circle() );
+            if( end > T() )
+            {
+                f( T(), end );
+            }
+        }
+    }
+
+    // The segment that contains the angle; boundaries[ 0 ] is always 0
+    std::size_t segment( angle_type angle ) const noexcept
+    {
+        const auto value = angle.normalized_abs().angle();
+
+        const T *   base  = boundaries.data();
+        std::size_t count = boundaries.size();
+        while( count > 1 )
+        {
+            const auto half = count / 2;
+            base   = base[ half ] <= value ? base + half : base;
+            count -= half;
+        }
+
+        // Rounding of normalize_abs may give a full circle, which is the start of the first segment
+        const auto s = static_cast< std::size_t >( base - boundaries.data() );
+        return value < full_circle() ? s : 0;
+    }
+
+    void rebuild()
+    {
+        boundaries.assign( 1, T() );
+        for( const auto & interval : intervals )
+        {
+            split( interval.first, interval.last, [ & ]( T begin, T end )
+            {
+                boundaries.push_back( begin );
+                if( end < full_circle() )
+                {
+                    boundaries.push_back( end );
+                }
+            } );
+        }
+        std::sort( boundaries.begin(), boundaries.end() );
+        boundaries.erase( std::unique( boundaries.begin(), boundaries.end() ), boundaries.end() );
+
+        // Count, then fill the intervals of each segment; the intervals are visited in order so each segment is sorted
+        const auto index = [ & ]( T value )
+        {
+            return static_cast< std::size_t >( std::lower_bound( boundaries.begin(), boundaries.end(), value ) - boundaries.begin() );
+        };
+
+        offsets.assign( boundaries.size() + 1, 0 );
+        for( const auto & interval : intervals )
+        {
+            split( interval.first, interval.last, [ & ]( T begin, T end )
+            {
+                for( auto s = index( begin ), e = index( end ) ; s < e ; ++s )
+                {
+                    ++offsets[ s + 1 ];
+                }
+            } );
+        }
+        for( std::size_t s = 1 ; s < offsets.size() ; ++s )
+        {
+            offsets[ s ] += offsets[ s - 1 ];
+        }
+
+        ids.resize( offsets.back() );
+        std::vector< std::size_t > next( offsets.begin(), offsets.end() - 1 );
+        for( std::size_t i = 0 ; i < intervals.size() ; ++i )
+        {
+            split( intervals[ i ].first, intervals[ i ].last, [ & ]( T begin, T end )
+            {
+                for( auto s = index( begin ), e = index( end ) ; s < e ; ++s )
+                {
+                    ids[ next[ s ]++ ] = i;
+                }
+            } );
+        }
+    }
+
+    std::vector< interval_type > intervals;
+    std::vector< T >             boundaries; // Sorted starts of the segments between 0 and the full circle
+    std::vector< std::size_t >   offsets;    // The intervals of segment s are ids[ offsets[ s ] ] up to ids[ offsets[ s + 1 ] ]
+    std::vector< std::size_t >   ids;
+};
+
+}
+
+}
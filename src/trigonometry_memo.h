@@ -0,0 +1,200 @@
+// See LICENSE for the Copyright Notice
+
+#pragma once
+
+#include "trigonometry.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+// The number of entries of each sincos cache is 2^PG_TRIGONOMETRY_SINCOS_CACHE_BITS
+#ifndef PG_TRIGONOMETRY_SINCOS_CACHE_BITS
+# define PG_TRIGONOMETRY_SINCOS_CACHE_BITS 14
+#endif
+
+namespace pg
+{
+
+namespace math
+{
+
+/**
+ * \brief The number of lookups of a sincos cache of the calling thread that found and that computed the results.
+ */
+struct sincos_cache_statistics
+{
+    std::uint64_t hits;
+    std::uint64_t misses;
+};
+
+namespace detail
+{
+
+namespace memo
+{
+
+constexpr unsigned    index_bits = PG_TRIGONOMETRY_SINCOS_CACHE_BITS;
+constexpr std::size_t entries    = std::size_t( 1 ) << index_bits;
+
+static_assert( index_bits > 0 && index_bits < 32, "PG_TRIGONOMETRY_SINCOS_CACHE_BITS must be between 1 and 31" );
+
+template< typename T >
+inline std::uint64_t key( T value ) noexcept
+{
+    static_assert( sizeof( T ) <= sizeof( std::uint64_t ), "The sincos cache supports values of at most 64 bits" );
+
+    std::uint64_t bits = 0;
+    std::memcpy( &bits, &value, sizeof( T ) );
+    return bits;
+}
+
+// Fibonacci hashing; the top bits of the product depend on all the bits of the key
+inline std::size_t slot( std::uint64_t key ) noexcept
+{
+    return static_cast< std::size_t >( ( key * 0x9E3779B97F4A7C15ULL ) >> ( 64 - index_bits ) );
+}
+
+// A direct-mapped cache of one angle type and precision policy for the calling thread
+template< typename T, typename CONV, typename P >
+struct cache
+{
+    using result_type = decltype( pg::math::sin< P >( std::declval< basic_angle< T, CONV > >() ) );
+
+    struct entry
+    {
+        std::uint64_t key;
+        result_type   sin;
+        result_type   cos;
+    };
+
+    std::vector< entry >    table;
+    sincos_cache_statistics statistics = { 0, 0 };
+
+    cache()
+        : table( entries )
+    {
+        clear();
+    }
+
+    // An empty entry has a key that maps to another slot, so no lookup matches it
+    void clear() noexcept
+    {
+        for( std::size_t i = 0 ; i < table.size() ; ++i )
+        {
+            table[ i ] = { slot( 0 ) == i ? 1u : 0u, result_type(), result_type() };
+        }
+        statistics = { 0, 0 };
+    }
+
+    static cache & local()
+    {
+        static thread_local cache instance;
+        return instance;
+    }
+
+    const entry & lookup( basic_angle< T, CONV > x )
+    {
+        const auto k = key( x.angle() );
+        auto &     e = table[ slot( k ) ];
+        if( e.key == k )
+        {
+            ++statistics.hits;
+        }
+        else
+        {
+            ++statistics.misses;
+            e = { k, pg::math::sin< P >( x ), pg::math::cos< P >( x ) };
+        }
+        return e;
+    }
+};
+
+template< typename ANGLE, typename P >
+using cache_t = cache< typename ANGLE::value_type, typename ANGLE::conversion, trig::precision_t< P, typename ANGLE::conversion > >;
+
+}
+
+}
+
+/**
+ * \brief Computes the sine and cosine of an angle object with a per-thread memoization cache.
+ *
+ * Each thread has a direct-mapped cache of 2^PG_TRIGONOMETRY_SINCOS_CACHE_BITS entries for each angle type and
+ * precision policy, keyed by the bit pattern of the value. A hit returns the stored results, a miss computes them with
+ * \em sin and \em cos and replaces the entry; the results are always the same as those of \em sin and \em cos.
+ * The cache pays off when the angles repeat, e.g. headings that a sensor quantizes to a few thousand values, and
+ * when the precision policy is expensive; see the \em memo benchmark.
+ *
+ * \tparam P The precision policy; \em precise, \em fast or \em fastest.
+ *           Defaults to the \em precision of the conversion object of \em x when available, otherwise \em precise.
+ */
+template< typename P = void, typename T, typename CONV, typename R >
+inline void cached_sincos( basic_angle< T, CONV > x, R & sin_result, R & cos_result )
+{
+    const auto & e = detail::memo::cache_t< basic_angle< T, CONV >, P >::local().lookup( x );
+    sin_result = static_cast< R >( e.sin );
+    cos_result = static_cast< R >( e.cos );
+}
+
+/**
+ * \brief Computes the sine of an angle object with a per-thread memoization cache; see \em cached_sincos.
+ */
+template< typename P = void, typename T, typename CONV >
+PG_TRIGONOMETRY_NODISCARD inline auto cached_sin( basic_angle< T, CONV > x )
+{
+    return detail::memo::cache_t< basic_angle< T, CONV >, P >::local().lookup( x ).sin;
+}
+
+/**
+ * \brief Computes the cosine of an angle object with a per-thread memoization cache; see \em cached_sincos.
+ */
+template< typename P = void, typename T, typename CONV >
+PG_TRIGONOMETRY_NODISCARD inline auto cached_cos( basic_angle< T, CONV > x )
+{
+    return detail::memo::cache_t< basic_angle< T, CONV >, P >::local().lookup( x ).cos;
+}
+
+/**
+ * \brief Computes the sines and cosines of an array of angle objects with the per-thread memoization cache; see \em cached_sincos.
+ *
+ * \param x          Pointer to the angle objects.
+ * \param count      The number of angle objects.
+ * \param sin_result Pointer to the array that receives \em count sines.
+ * \param cos_result Pointer to the array that receives \em count cosines.
+ */
+template< typename P = void, typename T, typename CONV >
+inline void cached_sincos( const basic_angle< T, CONV > * x, std::size_t count, double * sin_result, double * cos_result )
+{
+    auto & cache = detail::memo::cache_t< basic_angle< T, CONV >, P >::local();
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        const auto & e = cache.lookup( x[ i ] );
+        sin_result[ i ] = static_cast< double >( e.sin );
+        cos_result[ i ] = static_cast< double >( e.cos );
+    }
+}
+
+/**
+ * \brief Returns the hits and misses of the sincos cache of the calling thread for an angle type and precision policy.
+ */
+template< typename ANGLE, typename P = void >
+PG_TRIGONOMETRY_NODISCARD inline sincos_cache_statistics sincos_cache_stats()
+{
+    return detail::memo::cache_t< ANGLE, P >::local().statistics;
+}
+
+/**
+ * \brief Empties the sincos cache of the calling thread for an angle type and precision policy and resets its statistics.
+ */
+template< typename ANGLE, typename P = void >
+inline void clear_sincos_cache()
+{
+    detail::memo::cache_t< ANGLE, P >::local().clear();
+}
+
+}
+
+}
@@ -0,0 +1,328 @@
+// See LICENSE for the Copyright Notice
+
+#pragma once
+
+#include "trigonometry.h"
+#include "trigonometry_batch.h"
+#include "trigonometry_unwrapped.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+
+namespace pg
+{
+
+namespace math
+{
+
+/**
+ * \brief The default number of values in a block of a pipeline.
+ */
+constexpr std::size_t default_block_size = 256;
+
+/**
+ * \brief A block of values that is passed between the stages of a pipeline.
+ *
+ * A block with a \em count of 0 marks the end of the stream.
+ */
+template< typename V, std::size_t N = default_block_size >
+struct block
+{
+    using value_type = V;
+
+    constexpr static std::size_t capacity = N;
+
+    std::size_t   count    = 0;
+    std::uint64_t sequence = 0;
+    V             values[ N ];
+};
+
+/**
+ * \brief A block with the sines and cosines of a block of angles.
+ *
+ * A block with a \em count of 0 marks the end of the stream.
+ */
+template< std::size_t N = default_block_size >
+struct sincos_block
+{
+    constexpr static std::size_t capacity = N;
+
+    std::size_t   count    = 0;
+    std::uint64_t sequence = 0;
+    double        sin[ N ];
+    double        cos[ N ];
+};
+
+/**
+ * \brief Lock-free ring buffer with a single producer thread and a single consumer thread.
+ *
+ * The elements are written and read in place; the producer fills the element returned by \em acquire
+ * and publishes it with \em commit, the consumer reads the element returned by \em front and releases it with \em pop.
+ * The producer and consumer indices are kept on separate cache lines together with a cached copy of the other index.
+ *
+ * \tparam T        The type of the elements.
+ * \tparam CAPACITY The number of elements; must be a power of two.
+ */
+template< typename T, std::size_t CAPACITY >
+class spsc_ring
+{
+    static_assert( CAPACITY && !( CAPACITY & ( CAPACITY - 1 ) ), "The capacity must be a power of two" );
+
+public:
+
+    using value_type = T;
+
+    spsc_ring() = default;
+    spsc_ring( const spsc_ring & ) = delete;
+    spsc_ring & operator =( const spsc_ring & ) = delete;
+
+#ifndef __cpp_aligned_new
+    // Before C++17 new does not align objects to cache lines; the address of the allocation is kept in front of the ring
+    static void * operator new( std::size_t size )
+    {
+        const auto allocation = ::operator new( size + cache_line );
+        const auto ring       = ( reinterpret_cast< std::uintptr_t >( allocation ) + cache_line ) & ~std::uintptr_t( cache_line - 1 );
+        reinterpret_cast< void ** >( ring )[ -1 ] = allocation;
+        return reinterpret_cast< void * >( ring );
+    }
+
+    static void operator delete( void * ring ) noexcept
+    {
+        ::operator delete( static_cast< void ** >( ring )[ -1 ] );
+    }
+#endif
+
+    /**
+     * \brief Returns the element to write, or a nullptr when the ring is full. Called by the producer.
+     */
+    PG_TRIGONOMETRY_NODISCARD T * acquire() noexcept
+    {
+        const auto head = producer.index.load( std::memory_order_relaxed );
+        if( head - producer.cached == CAPACITY )
+        {
+            producer.cached = consumer.index.load( std::memory_order_acquire );
+            if( head - producer.cached == CAPACITY )
+            {
+                return nullptr;
+            }
+        }
+        return &slots[ head & ( CAPACITY - 1 ) ];
+    }
+
+    /**
+     * \brief Publishes the element returned by \em acquire to the consumer. Called by the producer.
+     */
+    void commit() noexcept
+    {
+        producer.index.store( producer.index.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+    }
+
+    /**
+     * \brief Copies an element into the ring. Called by the producer.
+     *
+     * \return False when the ring is full.
+     */
+    bool try_push( const T & value ) noexcept( std::is_nothrow_copy_assignable< T >::value )
+    {
+        const auto slot = acquire();
+        if( !slot )
+        {
+            return false;
+        }
+
+        *slot = value;
+        commit();
+        return true;
+    }
+
+    /**
+     * \brief Returns the oldest element, or a nullptr when the ring is empty. Called by the consumer.
+     */
+    PG_TRIGONOMETRY_NODISCARD T * front() noexcept
+    {
+        const auto tail = consumer.index.load( std::memory_order_relaxed );
+        if( tail == consumer.cached )
+        {
+            consumer.cached = producer.index.load( std::memory_order_acquire );
+            if( tail == consumer.cached )
+            {
+                return nullptr;
+            }
+        }
+        return &slots[ tail & ( CAPACITY - 1 ) ];
+    }
+
+    /**
+     * \brief Releases the element returned by \em front to the producer. Called by the consumer.
+     */
+    void pop() noexcept
+    {
+        consumer.index.store( consumer.index.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+    }
+
+    /**
+     * \brief Copies the oldest element out of the ring. Called by the consumer.
+     *
+     * \return False when the ring is empty.
+     */
+    bool try_pop( T & value ) noexcept( std::is_nothrow_copy_assignable< T >::value )
+    {
+        const auto slot = front();
+        if( !slot )
+        {
+            return false;
+        }
+
+        value = *slot;
+        pop();
+        return true;
+    }
+
+private:
+
+    constexpr static std::size_t cache_line = 64;
+
+    // Each side starts a cache line of its own and fills it, so the indices of the producer and the consumer and the
+    // first slots never share a line
+    struct alignas( cache_line ) side
+    {
+        std::atomic< std::size_t > index{ 0 };
+        std::size_t                cached = 0; // The last seen index of the other side
+    };
+
+    side producer;
+    side consumer;
+    T    slots[ CAPACITY ];
+};
+
+/**
+ * \brief Stage that normalizes blocks of angles between -/+ semicircle.
+ */
+struct normalize_stage
+{
+    template< typename T, typename CONV, std::size_t N >
+    void operator ()( const block< basic_angle< T, CONV >, N > & in, block< basic_angle< T, CONV >, N > & out ) const noexcept
+    {
+        normalized( in.values, in.count, out.values );
+    }
+};
+
+/**
+ * \brief Stage that normalizes blocks of angles between 0 and 2 * semicircle.
+ */
+struct normalize_abs_stage
+{
+    template< typename T, typename CONV, std::size_t N >
+    void operator ()( const block< basic_angle< T, CONV >, N > & in, block< basic_angle< T, CONV >, N > & out ) const noexcept
+    {
+        normalized_abs( in.values, in.count, out.values );
+    }
+};
+
+/**
+ * \brief Stage that converts blocks of angles to another angle type.
+ *
+ * \tparam TO The angle type of the output blocks.
+ */
+template< typename TO >
+struct cast_stage
+{
+    template< typename T, typename CONV, std::size_t N >
+    void operator ()( const block< basic_angle< T, CONV >, N > & in, block< TO, N > & out ) const noexcept
+    {
+        for( std::size_t i = 0 ; i < in.count ; ++i )
+        {
+            out.values[ i ] = angle_cast< TO >( in.values[ i ] );
+        }
+    }
+};
+
+/**
+ * \brief Stage that computes the sines and cosines of blocks of angles with the batch \em sincos.
+ *
+ * \tparam P The precision policy; \em precise, \em fast or \em fastest.
+ */
+template< typename P = void >
+struct sincos_stage
+{
+    template< typename T, typename CONV, std::size_t N >
+    void operator ()( const block< basic_angle< T, CONV >, N > & in, sincos_block< N > & out ) const noexcept
+    {
+        sincos< P >( in.values, in.count, out.sin, out.cos );
+    }
+};
+
+/**
+ * \brief Stage that unwraps a stream of sampled angles.
+ *
+ * The last unwrapped angle is kept so that the revolutions continue over the blocks.
+ */
+template< typename T, typename CONV >
+class unwrap_stage
+{
+public:
+
+    template< std::size_t N >
+    void operator ()( const block< basic_angle< T, CONV >, N > & in, block< basic_unwrapped_angle< T, CONV >, N > & out ) noexcept
+    {
+        previous = started ? unwrap( in.values, in.count, out.values, previous ) : unwrap( in.values, in.count, out.values );
+        started  = true;
+    }
+
+private:
+
+    basic_unwrapped_angle< T, CONV > previous;
+    bool                             started = false;
+};
+
+/**
+ * \brief Runs a stage on the blocks of an input ring and writes the results to an output ring until the end of the stream.
+ *
+ * The end of stream block is forwarded to the output ring before returning. The function waits by
+ * yielding the thread while the input ring is empty or the output ring is full.
+ *
+ * \param stage  The stage that is called with an input block and an output block.
+ * \param input  The ring this thread consumes.
+ * \param output The ring this thread produces.
+ */
+template< typename STAGE, typename IN, std::size_t IN_CAPACITY, typename OUT, std::size_t OUT_CAPACITY >
+void run_stage( STAGE & stage, spsc_ring< IN, IN_CAPACITY > & input, spsc_ring< OUT, OUT_CAPACITY > & output )
+{
+    for( ;; )
+    {
+        const IN * in;
+        while( !( in = input.front() ) )
+        {
+            std::this_thread::yield();
+        }
+
+        OUT * out;
+        while( !( out = output.acquire() ) )
+        {
+            std::this_thread::yield();
+        }
+
+        const auto end = in->count == 0;
+        out->count    = in->count;
+        out->sequence = in->sequence;
+        if( !end )
+        {
+            stage( *in, *out );
+        }
+
+        output.commit();
+        input.pop();
+
+        if( end )
+        {
+            return;
+        }
+    }
+}
+
+}
+
+}
@@ -0,0 +1,343 @@
+// See LICENSE for the Copyright Notice
+
+#pragma once
+
+#include "trigonometry.h"
+#include "trigonometry_batch.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace pg
+{
+
+namespace math
+{
+
+template< typename ANGLE, typename BITS = std::uint16_t >
+class quantized_angles;
+
+namespace detail
+{
+
+namespace quantized
+{
+
+// The unit of the stored values; 2^bits of them are a full circle
+template< typename BITS >
+struct conversion
+{
+    constexpr static long double semicircle = static_cast< long double >( std::uint64_t( 1 ) << ( std::numeric_limits< BITS >::digits - 1 ) );
+};
+
+template< typename BITS >
+constexpr long double steps() noexcept
+{
+    return conversion< BITS >::semicircle * 2.0L;
+}
+
+// Exact rounding to the nearest step for integral values with a whole full circle of at most 2^32 units
+template< typename T, typename CONV >
+using is_exact = std::integral_constant< bool, ( normalization::is_exact< T, CONV >::value && normalization::full_circle< CONV >() <= 4294967296.0L ) >;
+
+template< typename BITS, typename T, typename CONV >
+inline BITS quantize( T value, std::true_type /* is_exact */ ) noexcept
+{
+    using work = normalization::work_t< T, CONV >;
+
+    constexpr auto full = static_cast< std::uint64_t >( normalization::full_circle< CONV >() );
+
+    auto remainder = normalization::remainder< T, CONV >( value );
+    remainder      = static_cast< work >( remainder < 0 ? remainder + static_cast< work >( full ) : remainder );
+
+    // A value that rounds up to the full circle wraps to 0
+    return static_cast< BITS >( ( ( static_cast< std::uint64_t >( remainder ) << std::numeric_limits< BITS >::digits ) + full / 2 ) / full );
+}
+
+template< typename BITS, typename T, typename CONV >
+inline BITS quantize( T value, std::false_type /* is_exact */ ) noexcept
+{
+    constexpr auto full     = normalization::full_circle< CONV >();
+    constexpr auto to_steps = steps< BITS >() / full;
+
+    // Reduced before the scaling, which would lose the fraction of large values
+    auto remainder = std::fmod( static_cast< long double >( value ), full );
+    if( remainder < 0.0L )
+    {
+        remainder += full;
+    }
+
+    // A value that rounds up to the full circle wraps to 0
+    return static_cast< BITS >( static_cast< std::uint64_t >( static_cast< double >( remainder * to_steps ) + 0.5 ) );
+}
+
+// The stored value as a signed number of steps between -/+ half of the steps
+template< typename BITS >
+inline double signed_steps( BITS value ) noexcept
+{
+    constexpr auto half = std::uint64_t( 1 ) << ( std::numeric_limits< BITS >::digits - 1 );
+    constexpr auto size = static_cast< double >( steps< BITS >() );
+
+    const auto v = static_cast< double >( value );
+    return value >= half ? v - size : v;
+}
+
+}
+
+}
+
+/**
+ * \brief A compact array of angles that are stored as 8, 16 or 32 bit binary angles, fractions of 2^bits of a full circle.
+ *
+ * The angles are normalized and rounded to the nearest \em resolution() when they are stored; 16 bits resolve about
+ * 0.0055 degrees and 32 bits about 8.4e-8 degrees in a quarter or an eighth of the memory of double angles.
+ * The batch functions below read the stored values and widen them to double in registers, so that bandwidth-bound
+ * loops over large arrays read 2 or 4 bytes per angle.
+ *
+ * \tparam BITS The unsigned integral storage type; \em std::uint8_t, \em std::uint16_t or \em std::uint32_t.
+ */
+template< typename T, typename CONV, typename BITS >
+class quantized_angles< basic_angle< T, CONV >, BITS >
+{
+    static_assert( std::is_integral< BITS >::value && std::is_unsigned< BITS >::value && sizeof( BITS ) <= 4,
+                   "The storage type must be an unsigned integral type of at most 32 bits" );
+
+public:
+
+    using angle_type   = basic_angle< T, CONV >;
+    using storage_type = BITS;
+
+    quantized_angles() = default;
+
+    quantized_angles( std::initializer_list< angle_type > angles )
+    {
+        assign( angles.begin(), angles.size() );
+    }
+
+    /**
+     * \brief Stores an array of angles.
+     *
+     * \param angles Pointer to the angle objects.
+     * \param count  The number of angle objects.
+     */
+    quantized_angles( const angle_type * angles, std::size_t count )
+    {
+        assign( angles, count );
+    }
+
+    /**
+     * \brief The angle between two neighbouring stored values in the unit of the angle type, e.g. 360 / 65536 for 16 bit degrees.
+     */
+    constexpr static long double resolution() noexcept
+    {
+        return detail::normalization::full_circle< CONV >() / detail::quantized::steps< BITS >();
+    }
+
+    /**
+     * \brief Returns the stored value of an angle; the number of steps of \em resolution() between 0 and 2^bits.
+     */
+    PG_TRIGONOMETRY_NODISCARD static BITS quantize( angle_type angle ) noexcept
+    {
+        return detail::quantized::quantize< BITS, T, CONV >( angle.angle(), detail::quantized::is_exact< T, CONV >() );
+    }
+
+    /**
+     * \brief Returns the angle of a stored value between 0 and 2 * semicircle; rounded to nearest for integral angles.
+     */
+    PG_TRIGONOMETRY_NODISCARD static angle_type dequantize( BITS value ) noexcept
+    {
+        return detail::batch::make_angle< angle_type >( static_cast< double >( value ) * static_cast< double >( resolution() ) );
+    }
+
+    /**
+     * \brief Replaces the stored angles with an array of angles.
+     *
+     * \param angles Pointer to the angle objects.
+     * \param count  The number of angle objects.
+     */
+    void assign( const angle_type * angles, std::size_t count )
+    {
+        values.resize( count );
+        for( std::size_t i = 0 ; i < count ; ++i )
+        {
+            values[ i ] = quantize( angles[ i ] );
+        }
+    }
+
+    void push_back( angle_type angle )
+    {
+        values.push_back( quantize( angle ) );
+    }
+
+    void set( std::size_t index, angle_type angle ) noexcept
+    {
+        values[ index ] = quantize( angle );
+    }
+
+    /**
+     * \brief Returns the stored angle between 0 and 2 * semicircle.
+     */
+    PG_TRIGONOMETRY_NODISCARD angle_type operator []( std::size_t index ) const noexcept
+    {
+        return dequantize( values[ index ] );
+    }
+
+    void reserve( std::size_t count )
+    {
+        values.reserve( count );
+    }
+
+    void resize( std::size_t count )
+    {
+        values.resize( count );
+    }
+
+    void clear() noexcept
+    {
+        values.clear();
+    }
+
+    PG_TRIGONOMETRY_NODISCARD std::size_t size() const noexcept
+    {
+        return values.size();
+    }
+
+    PG_TRIGONOMETRY_NODISCARD bool empty() const noexcept
+    {
+        return values.empty();
+    }
+
+    /**
+     * \brief The stored values; \em size() values of \em resolution() steps.
+     */
+    PG_TRIGONOMETRY_NODISCARD const BITS * data() const noexcept
+    {
+        return values.data();
+    }
+
+    PG_TRIGONOMETRY_NODISCARD BITS * data() noexcept
+    {
+        return values.data();
+    }
+
+private:
+
+    std::vector< BITS > values;
+};
+
+/**
+ * \brief Computes the sine and cosine of each angle of a quantized array.
+ *
+ * The stored values are widened to double and reduced exactly, so the loop is vectorizable and always
+ * within the domain of the polynomial kernels.
+ *
+ * \tparam P The precision policy; \em precise, \em fast or \em fastest.
+ *           Defaults to the \em precision of the conversion object when available, otherwise \em precise.
+ *
+ * \param x          The quantized angles.
+ * \param sin_result Pointer to the array that receives \em x.size() sines.
+ * \param cos_result Pointer to the array that receives \em x.size() cosines.
+ */
+template< typename P = void, typename T, typename CONV, typename BITS >
+inline void sincos( const quantized_angles< basic_angle< T, CONV >, BITS > & x, double * sin_result, double * cos_result ) noexcept
+{
+    const auto values = x.data();
+    for( std::size_t i = 0 ; i < x.size() ; ++i )
+    {
+        detail::trig::sincos_kernel< detail::quantized::conversion< BITS > >( detail::quantized::signed_steps( values[ i ] ), sin_result[ i ], cos_result[ i ],
+                                                                              detail::trig::precision_t< P, CONV >() );
+    }
+}
+
+/**
+ * \brief Computes the sine of each angle of a quantized array; see \em sincos.
+ *
+ * \param x      The quantized angles.
+ * \param result Pointer to the array that receives \em x.size() sines.
+ */
+template< typename P = void, typename T, typename CONV, typename BITS >
+inline void sin( const quantized_angles< basic_angle< T, CONV >, BITS > & x, double * result ) noexcept
+{
+    const auto values = x.data();
+    for( std::size_t i = 0 ; i < x.size() ; ++i )
+    {
+        double c;
+        detail::trig::sincos_kernel< detail::quantized::conversion< BITS > >( detail::quantized::signed_steps( values[ i ] ), result[ i ], c,
+                                                                              detail::trig::precision_t< P, CONV >() );
+    }
+}
+
+/**
+ * \brief Computes the cosine of each angle of a quantized array; see \em sincos.
+ *
+ * \param x      The quantized angles.
+ * \param result Pointer to the array that receives \em x.size() cosines.
+ */
+template< typename P = void, typename T, typename CONV, typename BITS >
+inline void cos( const quantized_angles< basic_angle< T, CONV >, BITS > & x, double * result ) noexcept
+{
+    const auto values = x.data();
+    for( std::size_t i = 0 ; i < x.size() ; ++i )
+    {
+        double s;
+        detail::trig::sincos_kernel< detail::quantized::conversion< BITS > >( detail::quantized::signed_steps( values[ i ] ), s, result[ i ],
+                                                                              detail::trig::precision_t< P, CONV >() );
+    }
+}
+
+/**
+ * \brief Widens the angles of a quantized array to angle objects between -/+ semicircle.
+ *
+ * \param x      The quantized angles.
+ * \param result Pointer to the array that receives \em x.size() angle objects.
+ */
+template< typename T, typename CONV, typename BITS >
+inline void normalized( const quantized_angles< basic_angle< T, CONV >, BITS > & x, basic_angle< T, CONV > * result ) noexcept
+{
+    constexpr auto scale  = static_cast< double >( quantized_angles< basic_angle< T, CONV >, BITS >::resolution() );
+    const auto     values = x.data();
+    for( std::size_t i = 0 ; i < x.size() ; ++i )
+    {
+        result[ i ] = detail::batch::make_angle< basic_angle< T, CONV > >( detail::quantized::signed_steps( values[ i ] ) * scale );
+    }
+}
+
+/**
+ * \brief Widens the angles of a quantized array to another angle type, between 0 and 2 * semicircle of that type.
+ *
+ * \tparam TO The angle type of the resulting array.
+ *
+ * \param x      The quantized angles.
+ * \param result Pointer to the array that receives \em x.size() angle objects.
+ */
+template< typename TO, typename T, typename CONV, typename BITS >
+inline void angle_cast( const quantized_angles< basic_angle< T, CONV >, BITS > & x, TO * result ) noexcept
+{
+    constexpr auto scale  = static_cast< double >( detail::normalization::full_circle< typename TO::conversion >() / detail::quantized::steps< BITS >() );
+    const auto     values = x.data();
+    for( std::size_t i = 0 ; i < x.size() ; ++i )
+    {
+        result[ i ] = detail::batch::make_angle< TO >( static_cast< double >( values[ i ] ) * scale );
+    }
+}
+
+/**
+ * \brief Widens the angles of a quantized array to angle objects between 0 and 2 * semicircle.
+ *
+ * \param x      The quantized angles.
+ * \param result Pointer to the array that receives \em x.size() angle objects.
+ */
+template< typename T, typename CONV, typename BITS >
+inline void normalized_abs( const quantized_angles< basic_angle< T, CONV >, BITS > & x, basic_angle< T, CONV > * result ) noexcept
+{
+    angle_cast< basic_angle< T, CONV > >( x, result );
+}
+
+}
+
+}
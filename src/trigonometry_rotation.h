@@ -0,0 +1,506 @@
+// See LICENSE for the Copyright Notice
+
+#pragma once
+
+#include "trigonometry.h"
+#include "trigonometry_batch.h"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace pg
+{
+
+namespace math
+{
+
+/**
+ * \brief The order of the axes of intrinsic Tait-Bryan rotations.
+ *
+ * For \em zyx the rotation is R = Rz( first ) * Ry( second ) * Rx( third ), which is yaw, pitch and roll.
+ */
+enum class axis_order
+{
+    xyz,
+    xzy,
+    yxz,
+    yzx,
+    zxy,
+    zyx
+};
+
+/**
+ * \brief Three angles of rotations about the axes of an \em axis_order.
+ */
+template< typename ANGLE >
+struct euler_angles
+{
+    ANGLE first;
+    ANGLE second;
+    ANGLE third;
+};
+
+/**
+ * \brief Row-major 3x3 rotation matrix.
+ */
+struct rotation_matrix
+{
+    double m[ 3 ][ 3 ];
+};
+
+/**
+ * \brief Unit quaternion.
+ */
+struct quaternion
+{
+    double w;
+    double x;
+    double y;
+    double z;
+};
+
+/**
+ * \brief A structure of arrays with an array for each element of rotation matrices.
+ */
+template< typename V = double >
+struct rotation_matrix_arrays
+{
+    V * m[ 3 ][ 3 ];
+};
+
+/**
+ * \brief A structure of arrays with an array for each component of quaternions.
+ */
+template< typename V = double >
+struct quaternion_arrays
+{
+    V * w;
+    V * x;
+    V * y;
+    V * z;
+};
+
+namespace detail
+{
+
+namespace rotation
+{
+
+constexpr int axes[ 6 ][ 3 ] = { { 0, 1, 2 }, { 0, 2, 1 }, { 1, 0, 2 }, { 1, 2, 0 }, { 2, 0, 1 }, { 2, 1, 0 } };
+
+constexpr int axis( axis_order order, int n ) noexcept
+{
+    return axes[ static_cast< int >( order ) ][ n ];
+}
+
+// +1 for the cyclic orders xyz, yzx and zxy, otherwise -1
+constexpr double parity( axis_order order ) noexcept
+{
+    return ( axis( order, 1 ) - axis( order, 0 ) + 3 ) % 3 == 1 ? 1.0 : -1.0;
+}
+
+template< typename P, typename T, typename CONV >
+inline void sincos( basic_angle< T, CONV > x, double & s, double & c ) noexcept
+{
+    s = static_cast< double >( pg::math::sin< P >( x ) );
+    c = static_cast< double >( pg::math::cos< P >( x ) );
+}
+
+// Multiplies the rows of matrix m by a rotation about axis i from the right
+template< typename M >
+inline void rotate_columns( M & m, int i, double s, double c ) noexcept
+{
+    const auto j = ( i + 1 ) % 3;
+    const auto k = ( i + 2 ) % 3;
+    for( int r = 0 ; r < 3 ; ++r )
+    {
+        const auto mj = m[ r ][ j ];
+        const auto mk = m[ r ][ k ];
+        m[ r ][ j ] =  c * mj + s * mk;
+        m[ r ][ k ] = -s * mj + c * mk;
+    }
+}
+
+template< axis_order ORDER >
+inline rotation_matrix compose( const double ( & s )[ 3 ], const double ( & c )[ 3 ] ) noexcept
+{
+    rotation_matrix r = { { { 1.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 } } };
+    for( int n = 0 ; n < 3 ; ++n )
+    {
+        rotate_columns( r.m, axis( ORDER, n ), s[ n ], c[ n ] );
+    }
+    return r;
+}
+
+// Hamilton product q * rotation about axis i by an angle with half angle sine s and cosine c
+inline quaternion rotate( const quaternion & q, int i, double s, double c ) noexcept
+{
+    const double v[ 3 ] = { q.x, q.y, q.z };
+    const auto   j      = ( i + 1 ) % 3;
+    const auto   k      = ( i + 2 ) % 3;
+
+    double r[ 3 ];
+    r[ i ] = c * v[ i ] + s * q.w;
+    r[ j ] = c * v[ j ] + s * v[ k ];
+    r[ k ] = c * v[ k ] - s * v[ j ];
+
+    return { c * q.w - s * v[ i ], r[ 0 ], r[ 1 ], r[ 2 ] };
+}
+
+template< axis_order ORDER >
+inline quaternion compose_quaternion( const double ( & s )[ 3 ], const double ( & c )[ 3 ] ) noexcept
+{
+    quaternion q = { 1.0, 0.0, 0.0, 0.0 };
+    for( int n = 0 ; n < 3 ; ++n )
+    {
+        q = rotate( q, axis( ORDER, n ), s[ n ], c[ n ] );
+    }
+    return q;
+}
+
+inline double matrix_element( const quaternion & q, int row, int column ) noexcept
+{
+    const double v[ 4 ] = { q.x, q.y, q.z, q.w };
+    if( row == column )
+    {
+        const auto j = ( row + 1 ) % 3;
+        const auto k = ( row + 2 ) % 3;
+        return 1.0 - 2.0 * ( v[ j ] * v[ j ] + v[ k ] * v[ k ] );
+    }
+
+    const auto k    = 3 - row - column;
+    const auto sign = ( column - row + 3 ) % 3 == 1 ? -1.0 : 1.0;
+    return 2.0 * ( v[ row ] * v[ column ] + sign * v[ 3 ] * v[ k ] );
+}
+
+template< typename ANGLE >
+inline basic_angle< double, typename ANGLE::conversion > half( ANGLE x ) noexcept
+{
+    return { static_cast< double >( x.angle() ) / 2.0 };
+}
+
+constexpr std::size_t block_size = 256;
+
+}
+
+}
+
+/**
+ * \brief Computes the rotation matrix of three intrinsic rotations.
+ *
+ * \tparam ORDER The axes of the rotations.
+ * \tparam P     The precision policy; \em precise, \em fast or \em fastest.
+ *
+ * \param first  The angle of the rotation about the first axis of \em ORDER.
+ * \param second The angle of the rotation about the second axis of \em ORDER.
+ * \param third  The angle of the rotation about the third axis of \em ORDER.
+ *
+ * \return The rotation matrix.
+ */
+template< axis_order ORDER, typename P = void, typename T, typename CONV >
+PG_TRIGONOMETRY_NODISCARD inline rotation_matrix to_rotation_matrix( basic_angle< T, CONV > first, basic_angle< T, CONV > second, basic_angle< T, CONV > third ) noexcept
+{
+    double s[ 3 ];
+    double c[ 3 ];
+    detail::rotation::sincos< P >( first, s[ 0 ], c[ 0 ] );
+    detail::rotation::sincos< P >( second, s[ 1 ], c[ 1 ] );
+    detail::rotation::sincos< P >( third, s[ 2 ], c[ 2 ] );
+
+    return detail::rotation::compose< ORDER >( s, c );
+}
+
+/**
+ * \brief Computes the quaternion of three intrinsic rotations.
+ *
+ * \tparam ORDER The axes of the rotations.
+ * \tparam P     The precision policy; \em precise, \em fast or \em fastest.
+ *
+ * \param first  The angle of the rotation about the first axis of \em ORDER.
+ * \param second The angle of the rotation about the second axis of \em ORDER.
+ * \param third  The angle of the rotation about the third axis of \em ORDER.
+ *
+ * \return The unit quaternion.
+ */
+template< axis_order ORDER, typename P = void, typename T, typename CONV >
+PG_TRIGONOMETRY_NODISCARD inline quaternion to_quaternion( basic_angle< T, CONV > first, basic_angle< T, CONV > second, basic_angle< T, CONV > third ) noexcept
+{
+    double s[ 3 ];
+    double c[ 3 ];
+    detail::rotation::sincos< P >( detail::rotation::half( first ), s[ 0 ], c[ 0 ] );
+    detail::rotation::sincos< P >( detail::rotation::half( second ), s[ 1 ], c[ 1 ] );
+    detail::rotation::sincos< P >( detail::rotation::half( third ), s[ 2 ], c[ 2 ] );
+
+    return detail::rotation::compose_quaternion< ORDER >( s, c );
+}
+
+/**
+ * \brief Computes the rotation matrix of a unit quaternion.
+ */
+PG_TRIGONOMETRY_NODISCARD inline rotation_matrix to_rotation_matrix( const quaternion & q ) noexcept
+{
+    rotation_matrix r;
+    for( int row = 0 ; row < 3 ; ++row )
+    {
+        for( int column = 0 ; column < 3 ; ++column )
+        {
+            r.m[ row ][ column ] = detail::rotation::matrix_element( q, row, column );
+        }
+    }
+    return r;
+}
+
+/**
+ * \brief Computes the angles of three intrinsic rotations from a rotation matrix.
+ *
+ * The second angle is between -/+ a quarter circle.
+ * In gimbal lock, when the second angle is a quarter circle, the third angle is 0.
+ *
+ * \tparam ORDER The axes of the rotations.
+ * \tparam TO    The angle type of the results.
+ * \tparam P     The precision policy; \em precise, \em fast or \em fastest.
+ *
+ * \param r A rotation matrix.
+ *
+ * \return The angles of the rotations about the axes of \em ORDER.
+ */
+template< axis_order ORDER, typename TO = rad, typename P = void >
+PG_TRIGONOMETRY_NODISCARD inline euler_angles< TO > to_euler_angles( const rotation_matrix & r ) noexcept
+{
+    constexpr auto a = detail::rotation::axis( ORDER, 0 );
+    constexpr auto b = detail::rotation::axis( ORDER, 1 );
+    constexpr auto c = detail::rotation::axis( ORDER, 2 );
+    constexpr auto e = detail::rotation::parity( ORDER );
+
+    // The arc sine of the second angle is the arc tangent of its sine and cosine, as for the batch asin, so that it has the precision policy as well
+    const auto sine   = std::min( 1.0, std::max( -1.0, e * r.m[ a ][ c ] ) );
+    const auto second = atan2< TO, P >( sine, std::sqrt( ( 1.0 - sine ) * ( 1.0 + sine ) ) );
+    if( std::abs( sine ) < 1.0 )
+    {
+        return { atan2< TO, P >( -e * r.m[ b ][ c ], r.m[ c ][ c ] ),
+                 second,
+                 atan2< TO, P >( -e * r.m[ a ][ b ], r.m[ a ][ a ] ) };
+    }
+
+    return { atan2< TO, P >( e * r.m[ c ][ b ], r.m[ b ][ b ] ), second, TO() };
+}
+
+/**
+ * \brief Computes the angles of three intrinsic rotations from a unit quaternion.
+ *
+ * \tparam ORDER The axes of the rotations.
+ * \tparam TO    The angle type of the results.
+ * \tparam P     The precision policy; \em precise, \em fast or \em fastest.
+ *
+ * \param q A unit quaternion.
+ *
+ * \return The angles of the rotations about the axes of \em ORDER.
+ */
+template< axis_order ORDER, typename TO = rad, typename P = void >
+PG_TRIGONOMETRY_NODISCARD inline euler_angles< TO > to_euler_angles( const quaternion & q ) noexcept
+{
+    return to_euler_angles< ORDER, TO, P >( to_rotation_matrix( q ) );
+}
+
+/**
+ * \brief Computes the rotation matrices of arrays of angles.
+ *
+ * The sines and cosines are computed with the batch functions in blocks.
+ *
+ * \tparam ORDER The axes of the rotations.
+ * \tparam P     The precision policy; \em precise, \em fast or \em fastest.
+ *
+ * \param first  Pointer to the angles of the rotations about the first axis of \em ORDER.
+ * \param second Pointer to the angles of the rotations about the second axis of \em ORDER.
+ * \param third  Pointer to the angles of the rotations about the third axis of \em ORDER.
+ * \param count  The number of rotations.
+ * \param result The arrays that receive \em count elements of the rotation matrices.
+ */
+template< axis_order ORDER, typename P = void, typename T, typename CONV >
+inline void to_rotation_matrices( const basic_angle< T, CONV > * first, const basic_angle< T, CONV > * second, const basic_angle< T, CONV > * third,
+                                  std::size_t count, const rotation_matrix_arrays<> & result ) noexcept
+{
+    using detail::rotation::block_size;
+
+    const basic_angle< T, CONV > * angles[ 3 ] = { first, second, third };
+    double s[ 3 ][ block_size ];
+    double c[ 3 ][ block_size ];
+
+    for( std::size_t offset = 0 ; offset < count ; offset += block_size )
+    {
+        const auto n = std::min( block_size, count - offset );
+        for( int a = 0 ; a < 3 ; ++a )
+        {
+            sincos< P >( angles[ a ] + offset, n, s[ a ], c[ a ] );
+        }
+
+        for( std::size_t i = 0 ; i < n ; ++i )
+        {
+            const double si[ 3 ] = { s[ 0 ][ i ], s[ 1 ][ i ], s[ 2 ][ i ] };
+            const double ci[ 3 ] = { c[ 0 ][ i ], c[ 1 ][ i ], c[ 2 ][ i ] };
+            const auto   r       = detail::rotation::compose< ORDER >( si, ci );
+            for( int row = 0 ; row < 3 ; ++row )
+            {
+                for( int column = 0 ; column < 3 ; ++column )
+                {
+                    result.m[ row ][ column ][ offset + i ] = r.m[ row ][ column ];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * \brief Computes the quaternions of arrays of angles.
+ *
+ * The sines and cosines are computed with the batch functions in blocks.
+ *
+ * \tparam ORDER The axes of the rotations.
+ * \tparam P     The precision policy; \em precise, \em fast or \em fastest.
+ *
+ * \param first  Pointer to the angles of the rotations about the first axis of \em ORDER.
+ * \param second Pointer to the angles of the rotations about the second axis of \em ORDER.
+ * \param third  Pointer to the angles of the rotations about the third axis of \em ORDER.
+ * \param count  The number of rotations.
+ * \param result The arrays that receive \em count components of the quaternions.
+ */
+template< axis_order ORDER, typename P = void, typename T, typename CONV >
+inline void to_quaternions( const basic_angle< T, CONV > * first, const basic_angle< T, CONV > * second, const basic_angle< T, CONV > * third,
+                            std::size_t count, const quaternion_arrays<> & result ) noexcept
+{
+    using detail::rotation::block_size;
+    using half_angle = basic_angle< double, CONV >;
+
+    const basic_angle< T, CONV > * angles[ 3 ] = { first, second, third };
+    half_angle halves[ block_size ];
+    double     s[ 3 ][ block_size ];
+    double     c[ 3 ][ block_size ];
+
+    for( std::size_t offset = 0 ; offset < count ; offset += block_size )
+    {
+        const auto n = std::min( block_size, count - offset );
+        for( int a = 0 ; a < 3 ; ++a )
+        {
+            for( std::size_t i = 0 ; i < n ; ++i )
+            {
+                halves[ i ] = detail::rotation::half( angles[ a ][ offset + i ] );
+            }
+            sincos< P >( halves, n, s[ a ], c[ a ] );
+        }
+
+        for( std::size_t i = 0 ; i < n ; ++i )
+        {
+            const double si[ 3 ] = { s[ 0 ][ i ], s[ 1 ][ i ], s[ 2 ][ i ] };
+            const double ci[ 3 ] = { c[ 0 ][ i ], c[ 1 ][ i ], c[ 2 ][ i ] };
+            const auto   q       = detail::rotation::compose_quaternion< ORDER >( si, ci );
+            result.w[ offset + i ] = q.w;
+            result.x[ offset + i ] = q.x;
+            result.y[ offset + i ] = q.y;
+            result.z[ offset + i ] = q.z;
+        }
+    }
+}
+
+/**
+ * \brief Computes the angles of three intrinsic rotations from arrays of rotation matrix elements.
+ *
+ * The angles are computed with the batch \em atan2 and \em asin functions in blocks.
+ * Unlike the scalar function the gimbal lock is not handled separately.
+ *
+ * \tparam ORDER The axes of the rotations.
+ * \tparam TO    The angle type of the results.
+ * \tparam P     The precision policy; \em precise, \em fast or \em fastest.
+ *
+ * \param r      The arrays with the elements of \em count rotation matrices.
+ * \param count  The number of rotation matrices.
+ * \param first  Pointer to the array that receives the angles about the first axis of \em ORDER.
+ * \param second Pointer to the array that receives the angles about the second axis of \em ORDER.
+ * \param third  Pointer to the array that receives the angles about the third axis of \em ORDER.
+ */
+template< axis_order ORDER, typename TO = rad, typename P = void >
+inline void to_euler_angles( const rotation_matrix_arrays< const double > & r, std::size_t count, TO * first, TO * second, TO * third ) noexcept
+{
+    using detail::rotation::block_size;
+
+    constexpr auto a = detail::rotation::axis( ORDER, 0 );
+    constexpr auto b = detail::rotation::axis( ORDER, 1 );
+    constexpr auto c = detail::rotation::axis( ORDER, 2 );
+    constexpr auto e = detail::rotation::parity( ORDER );
+
+    double y[ block_size ];
+    double x[ block_size ];
+
+    for( std::size_t offset = 0 ; offset < count ; offset += block_size )
+    {
+        const auto n = std::min( block_size, count - offset );
+
+        for( std::size_t i = 0 ; i < n ; ++i )
+        {
+            y[ i ] = -e * r.m[ b ][ c ][ offset + i ];
+            x[ i ] = r.m[ c ][ c ][ offset + i ];
+        }
+        atan2< TO, P >( y, x, n, first + offset );
+
+        for( std::size_t i = 0 ; i < n ; ++i )
+        {
+            y[ i ] = std::min( 1.0, std::max( -1.0, e * r.m[ a ][ c ][ offset + i ] ) );
+        }
+        asin< TO, P >( y, n, second + offset );
+
+        for( std::size_t i = 0 ; i < n ; ++i )
+        {
+            y[ i ] = -e * r.m[ a ][ b ][ offset + i ];
+            x[ i ] = r.m[ a ][ a ][ offset + i ];
+        }
+        atan2< TO, P >( y, x, n, third + offset );
+    }
+}
+
+/**
+ * \brief Computes the angles of three intrinsic rotations from arrays of quaternion components.
+ *
+ * \tparam ORDER The axes of the rotations.
+ * \tparam TO    The angle type of the results.
+ * \tparam P     The precision policy; \em precise, \em fast or \em fastest.
+ *
+ * \param q      The arrays with the components of \em count unit quaternions.
+ * \param count  The number of quaternions.
+ * \param first  Pointer to the array that receives the angles about the first axis of \em ORDER.
+ * \param second Pointer to the array that receives the angles about the second axis of \em ORDER.
+ * \param third  Pointer to the array that receives the angles about the third axis of \em ORDER.
+ */
+template< axis_order ORDER, typename TO = rad, typename P = void >
+inline void to_euler_angles( const quaternion_arrays< const double > & q, std::size_t count, TO * first, TO * second, TO * third ) noexcept
+{
+    using detail::rotation::block_size;
+
+    double elements[ 3 ][ 3 ][ block_size ];
+    rotation_matrix_arrays< const double > r;
+    for( int row = 0 ; row < 3 ; ++row )
+    {
+        for( int column = 0 ; column < 3 ; ++column )
+        {
+            r.m[ row ][ column ] = elements[ row ][ column ];
+        }
+    }
+
+    for( std::size_t offset = 0 ; offset < count ; offset += block_size )
+    {
+        const auto n = std::min( block_size, count - offset );
+        for( std::size_t i = 0 ; i < n ; ++i )
+        {
+            const quaternion qi = { q.w[ offset + i ], q.x[ offset + i ], q.y[ offset + i ], q.z[ offset + i ] };
+            for( int row = 0 ; row < 3 ; ++row )
+            {
+                for( int column = 0 ; column < 3 ; ++column )
+                {
+                    elements[ row ][ column ][ i ] = detail::rotation::matrix_element( qi, row, column );
+                }
+            }
+        }
+        to_euler_angles< ORDER, TO, P >( r, n, first + offset, second + offset, third + offset );
+    }
+}
+
+}
+
+}
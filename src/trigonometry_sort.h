@@ -0,0 +1,314 @@
+// See LICENSE for the Copyright Notice
+
+#pragma once
+
+#include "trigonometry.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace pg
+{
+
+namespace math
+{
+
+/**
+ * \brief The order in which \em radix_sort sorts angles.
+ */
+enum class sort_key
+{
+    value,      ///< The order of the values, the same as the comparison operators
+    normalized  ///< The order of the values normalized between 0 and 2 * semicircle, e.g. a sweep counter-clockwise from 0
+};
+
+namespace detail
+{
+
+namespace sort
+{
+
+// 11 bit digits keep the counters of a pass in the L1 cache and need 6 passes for 64 bit keys
+constexpr unsigned    digit_bits = 11;
+constexpr std::size_t digits     = std::size_t( 1 ) << digit_bits;
+
+// The smallest chunk of values for a thread of the parallel sort
+constexpr std::size_t min_chunk = 65536;
+
+template< typename T >
+using key_t = typename std::conditional< sizeof( T ) <= 4, std::uint32_t, std::uint64_t >::type;
+
+template< typename T >
+constexpr unsigned passes() noexcept
+{
+    return static_cast< unsigned >( ( sizeof( T ) * 8 + digit_bits - 1 ) / digit_bits );
+}
+
+// Two's complement values are monotone as unsigned values with the sign bit flipped
+template< typename T >
+inline key_t< T > key( T value, std::true_type /* is_integral */ ) noexcept
+{
+    using unsigned_t = typename std::make_unsigned< T >::type;
+
+    const auto sign = std::is_signed< T >::value ? key_t< T >( 1 ) << ( sizeof( T ) * 8 - 1 ) : key_t< T >( 0 );
+    return static_cast< key_t< T > >( static_cast< unsigned_t >( value ) ) ^ sign;
+}
+
+template< typename T >
+inline T value( key_t< T > key, std::true_type /* is_integral */ ) noexcept
+{
+    using unsigned_t = typename std::make_unsigned< T >::type;
+
+    const auto sign = std::is_signed< T >::value ? key_t< T >( 1 ) << ( sizeof( T ) * 8 - 1 ) : key_t< T >( 0 );
+    return static_cast< T >( static_cast< unsigned_t >( key ^ sign ) );
+}
+
+// IEEE-754 values are monotone as unsigned values when negative values have all bits and positive values the sign bit flipped
+template< typename T >
+inline key_t< T > key( T value, std::false_type /* is_integral */ ) noexcept
+{
+    static_assert( sizeof( T ) == 4 || sizeof( T ) == 8, "Only float and double angles are supported" );
+
+    key_t< T > bits;
+    std::memcpy( &bits, &value, sizeof( T ) );
+
+    const auto sign = key_t< T >( 1 ) << ( sizeof( T ) * 8 - 1 );
+    return bits & sign ? ~bits : bits | sign;
+}
+
+template< typename T >
+inline T value( key_t< T > key, std::false_type /* is_integral */ ) noexcept
+{
+    const auto sign = key_t< T >( 1 ) << ( sizeof( T ) * 8 - 1 );
+    const auto bits = key & sign ? key ^ sign : ~key;
+
+    T result;
+    std::memcpy( &result, &bits, sizeof( T ) );
+    return result;
+}
+
+template< typename T, typename CONV >
+inline void make_keys( const basic_angle< T, CONV > * angles, std::size_t count, sort_key order, key_t< T > * keys ) noexcept
+{
+    if( order == sort_key::normalized )
+    {
+        // Adding zero turns the -0 of normalized negative multiples of a full circle into +0
+        for( std::size_t i = 0 ; i < count ; ++i )
+        {
+            keys[ i ] = key( static_cast< T >( angles[ i ].normalized_abs().angle() + T() ), std::is_integral< T >() );
+        }
+    }
+    else
+    {
+        for( std::size_t i = 0 ; i < count ; ++i )
+        {
+            keys[ i ] = key( angles[ i ].angle(), std::is_integral< T >() );
+        }
+    }
+}
+
+inline unsigned chunks( std::size_t count, unsigned threads ) noexcept
+{
+    const auto hardware = threads ? threads : std::max( std::thread::hardware_concurrency(), 1u );
+    return static_cast< unsigned >( std::max( std::min< std::size_t >( hardware, count / min_chunk ), std::size_t( 1 ) ) );
+}
+
+// Calls task( chunk ) for each chunk on its own thread
+template< typename TASK >
+inline void run_chunks( unsigned chunks, TASK task )
+{
+    std::vector< std::thread > workers;
+    for( unsigned c = 1 ; c < chunks ; ++c )
+    {
+        workers.emplace_back( task, c );
+    }
+    task( 0u );
+
+    for( auto & w : workers )
+    {
+        w.join();
+    }
+}
+
+// The value type of a sort of the keys alone
+struct keys_only {};
+
+/*
+ * Stable LSD radix sort of the keys with the values; each thread counts and scatters its own contiguous chunk.
+ * A single thread counts the digits of all passes in one read of the keys.
+ */
+template< typename K, typename V >
+inline void lsd_sort( K * keys, V * values, std::size_t count, unsigned passes, unsigned threads )
+{
+    constexpr bool carry = !std::is_same< V, keys_only >::value;
+
+    using histogram = std::array< std::size_t, digits >;
+
+    const auto chunk_count = chunks( count, threads );
+    const auto chunk_size  = ( count + chunk_count - 1 ) / chunk_count;
+
+    std::vector< K >         key_buffer( count );
+    std::vector< V >         value_buffer( carry ? count : 0 );
+    std::vector< histogram > offsets( chunk_count );
+    std::vector< histogram > counts( chunk_count == 1 ? passes : 0 );
+
+    if( chunk_count == 1 )
+    {
+        for( auto & c : counts )
+        {
+            c.fill( 0 );
+        }
+        for( std::size_t i = 0 ; i < count ; ++i )
+        {
+            for( unsigned pass = 0 ; pass < passes ; ++pass )
+            {
+                ++counts[ pass ][ ( keys[ i ] >> ( pass * digit_bits ) ) & ( digits - 1 ) ];
+            }
+        }
+    }
+
+    K * source_keys        = keys;
+    V * source_values      = values;
+    K * destination_keys   = key_buffer.data();
+    V * destination_values = value_buffer.data();
+
+    for( unsigned pass = 0 ; pass < passes ; ++pass )
+    {
+        const auto shift = pass * digit_bits;
+
+        if( chunk_count == 1 )
+        {
+            offsets[ 0 ] = counts[ pass ];
+        }
+        else
+        {
+            run_chunks( chunk_count, [ & ]( unsigned c )
+            {
+                auto & h = offsets[ c ];
+                h.fill( 0 );
+                for( auto i = c * chunk_size ; i < std::min( count, ( c + 1 ) * chunk_size ) ; ++i )
+                {
+                    ++h[ ( source_keys[ i ] >> shift ) & ( digits - 1 ) ];
+                }
+            } );
+        }
+
+        // The digits are ordered first and the chunks within a digit next, which keeps the sort stable
+        std::size_t position = 0;
+        auto        skip     = false;
+        for( std::size_t d = 0 ; d < digits ; ++d )
+        {
+            const auto start = position;
+            for( auto & h : offsets )
+            {
+                const auto n = h[ d ];
+                h[ d ]    = position;
+                position += n;
+            }
+            skip = skip || position - start == count; // All keys have the same digit
+        }
+        if( skip )
+        {
+            continue;
+        }
+
+        run_chunks( chunk_count, [ & ]( unsigned c )
+        {
+            auto & next = offsets[ c ];
+            for( auto i = c * chunk_size ; i < std::min( count, ( c + 1 ) * chunk_size ) ; ++i )
+            {
+                const auto p = next[ ( source_keys[ i ] >> shift ) & ( digits - 1 ) ]++;
+                destination_keys[ p ] = source_keys[ i ];
+                if( carry )
+                {
+                    destination_values[ p ] = source_values[ i ];
+                }
+            }
+        } );
+
+        std::swap( source_keys, destination_keys );
+        std::swap( source_values, destination_values );
+    }
+
+    if( source_keys != keys )
+    {
+        std::copy( source_keys, source_keys + count, keys );
+    }
+    if( carry && source_values != values )
+    {
+        std::copy( source_values, source_values + count, values );
+    }
+}
+
+}
+
+}
+
+/**
+ * \brief Sorts an array of angle objects with a stable LSD radix sort.
+ *
+ * The angles are mapped to unsigned keys of the same order; integral values with their sign bit flipped and
+ * floating point values with the IEEE-754 bit trick, after normalization for \em sort_key::normalized.
+ * Each 11 bits of the keys are a counting pass over the array; passes where all keys have the same digit are skipped.
+ * When sorting by value only the keys are moved and converted back to the values.
+ * For floating point values -0 sorts before +0 by value, negative NaNs sort first and positive NaNs last.
+ *
+ * \param angles  Pointer to the angle objects.
+ * \param count   The number of angle objects.
+ * \param order   Sort by value or by the value normalized between 0 and 2 * semicircle.
+ * \param threads The maximum number of threads; 0 uses all hardware threads. Each thread sorts at least 65536 angles.
+ */
+template< typename T, typename CONV >
+inline void radix_sort( basic_angle< T, CONV > * angles, std::size_t count, sort_key order = sort_key::value, unsigned threads = 1 )
+{
+    using namespace detail::sort;
+
+    std::vector< key_t< T > > keys( count );
+    make_keys( angles, count, order, keys.data() );
+
+    if( order == sort_key::value )
+    {
+        // The keys are the values, so only the keys are moved
+        lsd_sort( keys.data(), static_cast< keys_only * >( nullptr ), count, passes< T >(), threads );
+        for( std::size_t i = 0 ; i < count ; ++i )
+        {
+            angles[ i ] = basic_angle< T, CONV >( value< T >( keys[ i ], std::is_integral< T >() ) );
+        }
+    }
+    else
+    {
+        lsd_sort( keys.data(), angles, count, passes< T >(), threads );
+    }
+}
+
+/**
+ * \brief Computes the permutation that sorts an array of angle objects with a stable LSD radix sort.
+ *
+ * The angles are not modified; see \em radix_sort for the keys.
+ *
+ * \param angles      Pointer to the angle objects.
+ * \param count       The number of angle objects.
+ * \param permutation Pointer to the array that receives \em count indices of the angles in sorted order.
+ * \param order       Sort by value or by the value normalized between 0 and 2 * semicircle.
+ * \param threads     The maximum number of threads; 0 uses all hardware threads. Each thread sorts at least 65536 angles.
+ */
+template< typename T, typename CONV >
+inline void radix_sort_permutation( const basic_angle< T, CONV > * angles, std::size_t count, std::size_t * permutation,
+                                    sort_key order = sort_key::value, unsigned threads = 1 )
+{
+    std::vector< detail::sort::key_t< T > > keys( count );
+    detail::sort::make_keys( angles, count, order, keys.data() );
+    std::iota( permutation, permutation + count, std::size_t( 0 ) );
+    detail::sort::lsd_sort( keys.data(), permutation, count, detail::sort::passes< T >(), threads );
+}
+
+}
+
+}
@@ -0,0 +1,259 @@
+// See LICENSE for the Copyright Notice
+
+#pragma once
+
+#include "trigonometry.h"
+
+#include <cmath>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace pg
+{
+
+namespace math
+{
+
+/**
+ * \brief The cosines and sines of k / size of a full circle for k in [0, size), e.g. the twiddle factors of an FFT of that size.
+ */
+struct twiddle_table
+{
+    std::vector< double > cos;
+    std::vector< double > sin;
+
+    PG_TRIGONOMETRY_NODISCARD std::size_t size() const noexcept
+    {
+        return cos.size();
+    }
+};
+
+/**
+ * \brief A twiddle table of a size that is known at compile time; see \em fixed_twiddles.
+ */
+template< std::size_t N >
+struct fixed_twiddle_table
+{
+    double cos[ N ];
+    double sin[ N ];
+};
+
+namespace detail
+{
+
+namespace twiddle
+{
+
+/*
+ * k / n of a circle is 4k / n quarter circles; the quadrant and the remainder r / n of a quarter circle follow with
+ * integer arithmetic, and a remainder above half a quarter circle is reflected so that only the first octant,
+ * r / n in [0, 1/2], is evaluated. The first octant is sampled every step / n quarter circles.
+ */
+struct octant_map
+{
+    std::size_t index;    // The sample of the first octant
+    std::size_t quadrant;
+    bool        reflect;  // The sample is 1/4 circle minus the angle within the quadrant
+};
+
+constexpr std::size_t step( std::size_t n ) noexcept
+{
+    return n % 4 == 0 ? 4 : n % 2 == 0 ? 2 : 1;
+}
+
+// The number of samples of the first octant; n / 8 + 1 when n is a multiple of 8
+constexpr std::size_t octant_samples( std::size_t n ) noexcept
+{
+    return n / 2 / step( n ) + 1;
+}
+
+constexpr octant_map reduce( std::size_t k, std::size_t n ) noexcept
+{
+    const auto quarters  = 4 * ( k % n );
+    const auto quadrant  = quarters / n;
+    const auto remainder = quarters - quadrant * n;
+    const auto reflect   = 2 * remainder > n;
+    return { ( reflect ? n - remainder : remainder ) / step( n ), quadrant, reflect };
+}
+
+// Maps the cosine and sine of a sample of the first octant to the angle
+constexpr void apply( octant_map m, double c0, double s0, double & c, double & s ) noexcept
+{
+    const auto c1 = m.reflect ? s0 : c0;
+    const auto s1 = m.reflect ? c0 : s0;
+
+    c = m.quadrant == 0 ? c1 : m.quadrant == 1 ? -s1 : m.quadrant == 2 ? -c1 : s1;
+    s = m.quadrant == 0 ? s1 : m.quadrant == 1 ? c1 : m.quadrant == 2 ? -s1 : -c1;
+}
+
+// The radians of a sample of the first octant
+constexpr long double sample_angle( std::size_t index, std::size_t n ) noexcept
+{
+    return static_cast< long double >( index * step( n ) ) * ( trig::pi_ld / 2.0L ) / static_cast< long double >( n );
+}
+
+inline void sample( long double x, double & c, double & s, precise ) noexcept
+{
+    c = static_cast< double >( std::cos( x ) );
+    s = static_cast< double >( std::sin( x ) );
+}
+
+template< typename P >
+inline void sample( long double x, double & c, double & s, P policy ) noexcept
+{
+    trig::sincos_kernel< rad_conv >( static_cast< double >( x ), s, c, policy );
+}
+
+// Taylor series that are accurate to long double within the first octant
+constexpr long double octant_sin( long double x ) noexcept
+{
+    auto term = x;
+    auto sum  = x;
+    for( int n = 1 ; n < 14 ; ++n )
+    {
+        term *= -x * x / ( ( 2 * n ) * ( 2 * n + 1 ) );
+        sum  += term;
+    }
+    return sum;
+}
+
+constexpr long double octant_cos( long double x ) noexcept
+{
+    auto term = 1.0L;
+    auto sum  = 1.0L;
+    for( int n = 1 ; n < 14 ; ++n )
+    {
+        term *= -x * x / ( ( 2 * n - 1 ) * ( 2 * n ) );
+        sum  += term;
+    }
+    return sum;
+}
+
+template< std::size_t N >
+constexpr fixed_twiddle_table< N > make_fixed_table() noexcept
+{
+    fixed_twiddle_table< N > table = {};
+    for( std::size_t k = 0 ; k < N ; ++k )
+    {
+        const auto m = reduce( k, N );
+        const auto x = sample_angle( m.index, N );
+        apply( m, static_cast< double >( octant_cos( x ) ), static_cast< double >( octant_sin( x ) ), table.cos[ k ], table.sin[ k ] );
+    }
+    return table;
+}
+
+// Process-wide cache of the tables of a precision policy
+template< typename P >
+struct cache
+{
+    static std::mutex                                                    mutex;
+    static std::map< std::size_t, std::shared_ptr< const twiddle_table > > tables;
+};
+
+template< typename P >
+std::mutex cache< P >::mutex;
+
+template< typename P >
+std::map< std::size_t, std::shared_ptr< const twiddle_table > > cache< P >::tables;
+
+}
+
+}
+
+/**
+ * \brief Computes the cosines and sines of k / n of a full circle for k in [0, n).
+ *
+ * The angles are reduced to the first octant with integer arithmetic, so that only n / 8 + 1 angles are evaluated
+ * when n is a multiple of 8 and the values are exactly symmetric; e.g. the quarter circles are exactly 0 and -/+1.
+ *
+ * \tparam P The precision policy; \em precise evaluates in long double, \em fast and \em fastest use the polynomial kernels.
+ *
+ * \param n The number of angles; must not be 0.
+ */
+template< typename P = precise >
+PG_TRIGONOMETRY_NODISCARD inline twiddle_table make_twiddle_table( std::size_t n )
+{
+    using namespace detail::twiddle;
+
+    std::vector< double > octant_cos( octant_samples( n ) );
+    std::vector< double > octant_sin( octant_samples( n ) );
+    for( std::size_t i = 0 ; i < octant_cos.size() ; ++i )
+    {
+        sample( sample_angle( i, n ), octant_cos[ i ], octant_sin[ i ], P() );
+    }
+
+    twiddle_table table = { std::vector< double >( n ), std::vector< double >( n ) };
+    for( std::size_t k = 0 ; k < n ; ++k )
+    {
+        const auto m = reduce( k, n );
+        apply( m, octant_cos[ m.index ], octant_sin[ m.index ], table.cos[ k ], table.sin[ k ] );
+    }
+    return table;
+}
+
+/**
+ * \brief Returns the twiddle table of size \em n from a process-wide cache, computing it on first use.
+ *
+ * The cache is keyed by the size and the precision policy and can be used from multiple threads;
+ * the tables are computed outside of the lock and stay in the cache until \em clear_twiddle_cache is called.
+ *
+ * \tparam P The precision policy; \em precise, \em fast or \em fastest.
+ *
+ * \param n The number of angles; must not be 0.
+ */
+template< typename P = precise >
+PG_TRIGONOMETRY_NODISCARD inline std::shared_ptr< const twiddle_table > twiddles( std::size_t n )
+{
+    using cache = detail::twiddle::cache< P >;
+
+    {
+        std::lock_guard< std::mutex > lock( cache::mutex );
+        const auto found = cache::tables.find( n );
+        if( found != cache::tables.end() )
+        {
+            return found->second;
+        }
+    }
+
+    auto table = std::make_shared< const twiddle_table >( make_twiddle_table< P >( n ) );
+
+    // Another thread may have computed the same table in the meantime
+    std::lock_guard< std::mutex > lock( cache::mutex );
+    return cache::tables.emplace( n, std::move( table ) ).first->second;
+}
+
+/**
+ * \brief Removes the tables of a precision policy from the cache; tables that are still referenced stay valid.
+ */
+template< typename P = precise >
+inline void clear_twiddle_cache()
+{
+    using cache = detail::twiddle::cache< P >;
+
+    std::lock_guard< std::mutex > lock( cache::mutex );
+    cache::tables.clear();
+}
+
+/**
+ * \brief Holds the twiddle table of size \em N that is computed at compile time.
+ *
+ * The values are computed with long double series on the first octant and are usually correctly rounded.
+ * Large sizes may exceed the constant evaluation limits of the compiler.
+ */
+template< std::size_t N >
+struct fixed_twiddles
+{
+    static_assert( N > 0, "The size must not be 0" );
+
+    constexpr static fixed_twiddle_table< N > table = detail::twiddle::make_fixed_table< N >();
+};
+
+template< std::size_t N >
+constexpr fixed_twiddle_table< N > fixed_twiddles< N >::table;
+
+}
+
+}
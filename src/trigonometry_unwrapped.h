@@ -0,0 +1,369 @@
+// See LICENSE for the Copyright Notice
+
+#pragma once
+
+#include "trigonometry.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace pg
+{
+
+namespace math
+{
+
+namespace detail
+{
+
+namespace unwrapped
+{
+
+// Selects the constructor that takes a fraction that is already within a single revolution
+struct normalized_fraction {};
+
+template< typename T, typename CONV >
+constexpr T full_circle() noexcept
+{
+    return static_cast< T >( CONV::semicircle * 2 );
+}
+
+template< typename T >
+inline void split( T value, T full, std::int64_t & revolutions, T & fraction, std::true_type /* is_integral */ ) noexcept
+{
+    revolutions = value / full;
+    fraction    = static_cast< T >( value % full );
+    if( fraction < 0 )
+    {
+        fraction += full;
+        --revolutions;
+    }
+}
+
+template< typename T >
+inline void split( T value, T full, std::int64_t & revolutions, T & fraction, std::false_type /* is_integral */ ) noexcept
+{
+    revolutions = static_cast< std::int64_t >( std::floor( value / full ) );
+    fraction    = static_cast< T >( value - static_cast< T >( revolutions ) * full );
+}
+
+}
+
+}
+
+/**
+ * \brief Angle that keeps the number of whole revolutions apart from the angle within a revolution.
+ *
+ * The fraction is kept between 0 and 2 * semicircle like \em basic_angle::normalize_abs does.
+ * The precision of the fraction does not degrade when the number of revolutions grows, and
+ * additions are exact for integral storage types.
+ *
+ * \tparam T The storage type of the fraction
+ * \tparam CONV The conversion object with a constexpr static \em semicircle containing the value for a half circle.
+ */
+template< typename T, typename CONV >
+class basic_unwrapped_angle
+{
+public:
+
+    using value_type = T;
+    using conversion = CONV;
+    using angle_type = basic_angle< T, CONV >;
+
+    constexpr basic_unwrapped_angle() = default;
+
+    /**
+     * \brief Constructs an unwrapped angle from a number of revolutions and an angle.
+     *
+     * The angle may be outside a single revolution; whole revolutions are moved to the revolution count.
+     */
+    basic_unwrapped_angle( std::int64_t revolutions, angle_type angle ) noexcept
+    {
+        T fraction;
+        detail::unwrapped::split( angle.angle(), full_circle(), revs, fraction, std::is_integral< T >() );
+        revs += revolutions;
+        frac  = fraction;
+        carry();
+    }
+
+    constexpr basic_unwrapped_angle( std::int64_t revolutions, T fraction, detail::unwrapped::normalized_fraction ) noexcept
+        : revs( revolutions )
+        , frac( fraction )
+    {}
+
+    /**
+     * \brief Constructs an unwrapped angle from an angle that contains any number of revolutions.
+     */
+    explicit basic_unwrapped_angle( angle_type angle ) noexcept
+        : basic_unwrapped_angle( 0, angle )
+    {}
+
+    /**
+     * \brief Returns the number of whole revolutions.
+     */
+    PG_TRIGONOMETRY_NODISCARD constexpr std::int64_t revolutions() const noexcept
+    {
+        return revs;
+    }
+
+    /**
+     * \brief Returns the angle within the revolution, between 0 and 2 * semicircle.
+     */
+    PG_TRIGONOMETRY_NODISCARD constexpr angle_type fraction() const noexcept
+    {
+        return { frac };
+    }
+
+    /**
+     * \brief Returns the revolutions and fraction as a single angle object.
+     *
+     * The result is subject to the precision of \em T.
+     */
+    PG_TRIGONOMETRY_NODISCARD angle_type angle() const noexcept
+    {
+        return { static_cast< T >( static_cast< T >( revs ) * full_circle() + frac ) };
+    }
+
+    basic_unwrapped_angle & operator +=( basic_unwrapped_angle other ) noexcept
+    {
+        revs += other.revs;
+        frac += other.frac;
+        carry();
+        return *this;
+    }
+
+    basic_unwrapped_angle & operator -=( basic_unwrapped_angle other ) noexcept
+    {
+        revs -= other.revs;
+        frac -= other.frac;
+        carry();
+        return *this;
+    }
+
+    basic_unwrapped_angle & operator +=( angle_type other ) noexcept
+    {
+        return *this += basic_unwrapped_angle( other );
+    }
+
+    basic_unwrapped_angle & operator -=( angle_type other ) noexcept
+    {
+        return *this -= basic_unwrapped_angle( other );
+    }
+
+private:
+
+    constexpr static T full_circle() noexcept
+    {
+        return detail::unwrapped::full_circle< T, CONV >();
+    }
+
+    // Moves the fraction back into a single revolution after adding or subtracting two fractions
+    void carry() noexcept
+    {
+        if( frac >= full_circle() )
+        {
+            frac -= full_circle();
+            ++revs;
+        }
+        else if( frac < T() )
+        {
+            frac += full_circle();
+            --revs;
+        }
+    }
+
+    std::int64_t revs = 0;
+    T            frac = T();
+};
+
+using unwrapped_deg  = basic_unwrapped_angle< double, deg_conv >;
+using unwrapped_rad  = basic_unwrapped_angle< double, rad_conv >;
+using unwrapped_grad = basic_unwrapped_angle< double, grad_conv >;
+
+template< typename T, typename CONV >
+PG_TRIGONOMETRY_NODISCARD basic_unwrapped_angle< T, CONV > operator -( basic_unwrapped_angle< T, CONV > angle ) noexcept
+{
+    return basic_unwrapped_angle< T, CONV >() -= angle;
+}
+
+template< typename T, typename CONV >
+PG_TRIGONOMETRY_NODISCARD basic_unwrapped_angle< T, CONV > operator +( basic_unwrapped_angle< T, CONV > left, basic_unwrapped_angle< T, CONV > right ) noexcept
+{
+    return left += right;
+}
+
+template< typename T, typename CONV >
+PG_TRIGONOMETRY_NODISCARD basic_unwrapped_angle< T, CONV > operator -( basic_unwrapped_angle< T, CONV > left, basic_unwrapped_angle< T, CONV > right ) noexcept
+{
+    return left -= right;
+}
+
+template< typename T, typename CONV >
+PG_TRIGONOMETRY_NODISCARD basic_unwrapped_angle< T, CONV > operator +( basic_unwrapped_angle< T, CONV > left, basic_angle< T, CONV > right ) noexcept
+{
+    return left += right;
+}
+
+template< typename T, typename CONV >
+PG_TRIGONOMETRY_NODISCARD basic_unwrapped_angle< T, CONV > operator -( basic_unwrapped_angle< T, CONV > left, basic_angle< T, CONV > right ) noexcept
+{
+    return left -= right;
+}
+
+template< typename T, typename CONV >
+PG_TRIGONOMETRY_NODISCARD constexpr bool operator ==( basic_unwrapped_angle< T, CONV > left, basic_unwrapped_angle< T, CONV > right ) noexcept
+{
+    return left.revolutions() == right.revolutions() && left.fraction() == right.fraction();
+}
+
+template< typename T, typename CONV >
+PG_TRIGONOMETRY_NODISCARD constexpr bool operator !=( basic_unwrapped_angle< T, CONV > left, basic_unwrapped_angle< T, CONV > right ) noexcept
+{
+    return !( left == right );
+}
+
+template< typename T, typename CONV >
+PG_TRIGONOMETRY_NODISCARD constexpr bool operator <( basic_unwrapped_angle< T, CONV > left, basic_unwrapped_angle< T, CONV > right ) noexcept
+{
+    return left.revolutions() < right.revolutions() ||
+         ( left.revolutions() == right.revolutions() && left.fraction() < right.fraction() );
+}
+
+template< typename T, typename CONV >
+PG_TRIGONOMETRY_NODISCARD constexpr bool operator >( basic_unwrapped_angle< T, CONV > left, basic_unwrapped_angle< T, CONV > right ) noexcept
+{
+    return right < left;
+}
+
+template< typename T, typename CONV >
+PG_TRIGONOMETRY_NODISCARD constexpr bool operator <=( basic_unwrapped_angle< T, CONV > left, basic_unwrapped_angle< T, CONV > right ) noexcept
+{
+    return !( right < left );
+}
+
+template< typename T, typename CONV >
+PG_TRIGONOMETRY_NODISCARD constexpr bool operator >=( basic_unwrapped_angle< T, CONV > left, basic_unwrapped_angle< T, CONV > right ) noexcept
+{
+    return !( left < right );
+}
+
+/**
+ * \brief Returns unwrapped angle object of the given type that is derived another unwrapped angle object.
+ *
+ * The revolutions are kept; only the fraction is converted.
+ *
+ * \tparam TO The type of the returned unwrapped angle object.
+ *
+ * \param from The unwrapped angle object from which the new unwrapped angle object is derived.
+ *
+ * \return A new unwrapped angle object of type \em TO with a value derived from \em from.
+ */
+template< typename TO, typename FROM_T, typename FROM_CONV >
+PG_TRIGONOMETRY_NODISCARD inline TO angle_cast( basic_unwrapped_angle< FROM_T, FROM_CONV > from ) noexcept
+{
+    return { from.revolutions(), angle_cast< typename TO::angle_type >( from.fraction() ) };
+}
+
+/**
+ * \brief Computes the sine of the fraction of an unwrapped angle.
+ *
+ * \tparam P The precision policy; \em precise, \em fast or \em fastest.
+ */
+template< typename P = void, typename T, typename CONV >
+PG_TRIGONOMETRY_NODISCARD inline auto sin( basic_unwrapped_angle< T, CONV > x ) noexcept
+{
+    return sin< P >( x.fraction() );
+}
+
+/**
+ * \brief Computes the cosine of the fraction of an unwrapped angle.
+ *
+ * \tparam P The precision policy; \em precise, \em fast or \em fastest.
+ */
+template< typename P = void, typename T, typename CONV >
+PG_TRIGONOMETRY_NODISCARD inline auto cos( basic_unwrapped_angle< T, CONV > x ) noexcept
+{
+    return cos< P >( x.fraction() );
+}
+
+/**
+ * \brief Computes the tangent of the fraction of an unwrapped angle.
+ *
+ * \tparam P The precision policy; \em precise, \em fast or \em fastest.
+ */
+template< typename P = void, typename T, typename CONV >
+PG_TRIGONOMETRY_NODISCARD inline auto tan( basic_unwrapped_angle< T, CONV > x ) noexcept
+{
+    return tan< P >( x.fraction() );
+}
+
+/**
+ * \brief Unwraps a series of sampled angles that continues after \em previous.
+ *
+ * A step between two samples of more than a semicircle is taken as a wrap around to the next or previous revolution.
+ * The samples are processed in one pass so that a long series can be unwrapped block by block
+ * by passing the returned value of the previous block.
+ *
+ * \param samples  Pointer to the sampled angles; the samples may be in any range.
+ * \param count    The number of samples.
+ * \param result   Pointer to the array that receives \em count unwrapped angles.
+ * \param previous The unwrapped angle that preceded the first sample.
+ *
+ * \return The last unwrapped angle, or \em previous when \em count is 0.
+ */
+template< typename T, typename CONV >
+inline basic_unwrapped_angle< T, CONV > unwrap( const basic_angle< T, CONV > * samples, std::size_t count,
+                                                basic_unwrapped_angle< T, CONV > * result,
+                                                basic_unwrapped_angle< T, CONV > previous ) noexcept
+{
+    constexpr auto semicircle = static_cast< T >( CONV::semicircle );
+
+    constexpr auto full       = detail::unwrapped::full_circle< T, CONV >();
+
+    auto revolutions = previous.revolutions();
+    auto fraction    = previous.fraction().angle();
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        auto sample = samples[ i ].angle();
+        if( sample < T() || sample >= full )
+        {
+            sample = samples[ i ].normalized_abs().angle();
+            sample = sample < full ? sample : T();
+        }
+
+        const auto step = sample - fraction;
+        revolutions += ( step < -semicircle ) - ( step > semicircle );
+        fraction     = sample;
+        result[ i ]  = { revolutions, sample, detail::unwrapped::normalized_fraction() };
+    }
+
+    return count ? result[ count - 1 ] : previous;
+}
+
+/**
+ * \brief Unwraps a series of sampled angles starting in revolution 0.
+ *
+ * \param samples Pointer to the sampled angles; the samples may be in any range.
+ * \param count   The number of samples.
+ * \param result  Pointer to the array that receives \em count unwrapped angles.
+ *
+ * \return The last unwrapped angle.
+ */
+template< typename T, typename CONV >
+inline basic_unwrapped_angle< T, CONV > unwrap( const basic_angle< T, CONV > * samples, std::size_t count,
+                                                basic_unwrapped_angle< T, CONV > * result ) noexcept
+{
+    if( !count )
+    {
+        return {};
+    }
+
+    result[ 0 ] = basic_unwrapped_angle< T, CONV >( 0, samples[ 0 ].normalized_abs() );
+    return unwrap( samples + 1, count - 1, result + 1, result[ 0 ] );
+}
+
+}
+
+}
@@ -0,0 +1,116 @@
+// The probes of trigonometry.h change its inline functions, so this test is a program of its own
+#define PG_TRIGONOMETRY_INSTRUMENTATION
+
+#include <trigonometry.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+
+static int total_checks  = 0;
+static int failed_checks = 0;
+
+static bool report_failed_check( const char* const file, const int line, const char * const condition )
+{
+    std::cout << "check failed! (file " << file << ", line " << line << "): " << condition << '\n';
+    ++failed_checks;
+    return false;
+}
+
+#define assert_true( c ) do { ++total_checks; ( c ) || report_failed_check( __FILE__, __LINE__, #c ); } while( false )
+
+
+using namespace pg::math;
+
+namespace ins = pg::math::instrumentation;
+
+using ideg = basic_angle< int, deg_conv >;
+
+// The counters of a probe and angle type in a snapshot; an entry without calls when there are none
+static ins::snapshot_entry find( const std::vector< ins::snapshot_entry > & entries, ins::probe function, const std::string & angle_type )
+{
+    for( const auto & entry : entries )
+    {
+        if( entry.function == function && entry.angle_type == angle_type )
+        {
+            return entry;
+        }
+    }
+    return { function, angle_type, 0, {} };
+}
+
+// The exact normalizations stay constexpr with the probes; constant evaluations are not counted
+static_assert( ideg( 540 ).normalized().angle() == 180, "constexpr normalize" );
+static_assert( ideg( 270 ).normalized().angle() == -90, "constexpr normalize" );
+static_assert( ideg( -90 ).normalized_abs().angle() == 270, "constexpr normalize_abs" );
+static_assert( ideg( 720 ).normalized_abs().angle() == 0, "constexpr normalize_abs" );
+
+void probes()
+{
+    volatile double sink = 0.0;
+
+    sink = sink + sin( deg( 30 ) );
+    sink = sink + sin( deg( 1000 ) );
+    sink = sink + cos( deg( 300 ) );
+    sink = sink + tan( rad( 1e9 ) );
+
+    auto d = deg( 190 );
+    d.normalize();
+    auto i = ideg( -90 );
+    i.normalize_abs();
+    sink = sink + d.angle() + i.angle();
+
+    sink = sink + angle_cast< rad >( deg( 90 ) ).angle();
+
+    const auto entries = ins::take_snapshot();
+
+    const auto sines = find( entries, ins::probe::sin, "f64@180" );
+    assert_true( sines.calls == 2 );
+    assert_true( sines.histogram[ 0 ] == 1 && sines.histogram[ 2 ] == 1 );
+
+    const auto cosines = find( entries, ins::probe::cos, "f64@180" );
+    assert_true( cosines.calls == 1 && cosines.histogram[ 1 ] == 1 );
+
+    std::uint64_t tangents = 0;
+    for( const auto & entry : entries )
+    {
+        if( entry.function == ins::probe::tan )
+        {
+            assert_true( entry.angle_type.compare( 0, 4, "f64@" ) == 0 );
+            assert_true( entry.histogram[ 5 ] == entry.calls );
+            tangents += entry.calls;
+        }
+    }
+    assert_true( tangents == 1 );
+
+    assert_true( find( entries, ins::probe::normalize, "f64@180" ).calls == 1 );
+#ifdef PG_TRIGONOMETRY_IS_CONSTANT_EVALUATED
+    assert_true( find( entries, ins::probe::normalize_abs, "i32@180" ).calls == 1 );
+#else
+    assert_true( find( entries, ins::probe::normalize_abs, "i32@180" ).calls == 0 );
+#endif
+    assert_true( find( entries, ins::probe::angle_cast, "f64@180" ).calls == 1 );
+
+    // The calls of other threads are aggregated
+    std::thread worker( []
+    {
+        volatile double s = sin( deg( 45 ) );
+        static_cast< void >( s );
+    } );
+    worker.join();
+    assert_true( find( ins::take_snapshot(), ins::probe::sin, "f64@180" ).calls == 3 );
+
+    std::stringstream text;
+    ins::write_text( text, ins::take_snapshot() );
+    assert_true( text.str().find( "sin f64@180 calls=3 <=1=2 <=2=0 <=2^8=1" ) != std::string::npos );
+}
+
+int main()
+{
+    probes();
+
+    std::cout << "Total instrumentation tests: " << total_checks << ", Tests failed: " << failed_checks << '\n';
+
+    return failed_checks ? 1 : 0;
+}
@@ -0,0 +1,61 @@
+// Generated by tools/minimax.cpp: minimax semicircle128_fast_coefficients 128 fast 7 6 9
+
+#pragma once
+
+#include <trigonometry.h>
+
+/**
+ * \brief Minimax polynomials of the fast policy for a unit with a semicircle of 128.
+ *
+ * Maximum absolute errors: sin 2.41e-09, cos 2.76e-08, atan 7.27e-09 radians.
+ */
+struct semicircle128_fast_coefficients
+{
+    using precision = pg::math::fast;
+
+    constexpr static long double semicircle = 128L;
+
+    constexpr static double sin_error  = 2.414e-09;
+    constexpr static double cos_error  = 2.758e-08;
+    constexpr static double atan_error = 7.265e-09;
+
+    // sin( x ) / x with x in the unit as a polynomial of z = x^2 for |x| <= semicircle / 4
+    static double sin( double z ) noexcept
+    {
+        constexpr static double coefficients[] =
+        {
+             2.45436925307315097e-02,
+            -2.46415511566937665e-06,
+             7.42079951507809838e-11,
+            -1.04641389887140418e-15
+        };
+        return pg::math::detail::trig::polynomial( coefficients, z );
+    }
+
+    // cos( x ) with x in the unit as a polynomial of z = x^2 for |x| <= semicircle / 4
+    static double cos( double z ) noexcept
+    {
+        constexpr static double coefficients[] =
+        {
+             9.99999972423404437e-01,
+            -3.01195560119768416e-04,
+             1.51156570984352615e-08,
+            -2.96980616132241010e-13
+        };
+        return pg::math::detail::trig::polynomial( coefficients, z );
+    }
+
+    // atan( t ) / t in the unit as a polynomial of z = t^2 for |t| <= tan( pi / 8 )
+    static double atan( double z ) noexcept
+    {
+        constexpr static double coefficients[] =
+        {
+             4.07436647169106436e+01,
+            -1.35810077304310077e+01,
+             8.13843484222837077e+00,
+            -5.64481388684608021e+00,
+             3.25690366220077010e+00
+        };
+        return pg::math::detail::trig::polynomial( coefficients, z );
+    }
+};
@@ -1,9 +1,28 @@
 #include <trigonometry.h>
+#include <trigonometry_instrumentation.h>
+#include <trigonometry_batch.h>
+#include <trigonometry_unwrapped.h>
+#include <trigonometry_rotation.h>
+#include <trigonometry_geodesy.h>
+#include "semicircle128_fast_coefficients.h"
+#include <trigonometry_pipeline.h>
+#include <trigonometry_intervals.h>
+#include <trigonometry_circular_index.h>
+#include <trigonometry_sort.h>
+#include <trigonometry_twiddle.h>
+#include <trigonometry_cordic.h>
+#include <trigonometry_quantized.h>
+#include <trigonometry_dual.h>
+#include <trigonometry_memo.h>
+#include <trigonometry_harmonics.h>
 #include <iostream>
 #include <sstream>
 #include <algorithm>
 #include <numeric>
 #include <cmath>
+#include <thread>
+#include <memory>
+#include <array>
 
 
 #ifdef __cpp_lib_math_constants
@@ -225,6 +244,11 @@ void normalize()
     assert_same( deg2n.angle(), 90 );
     assert_same( deg2.angle(), 90 );
 
+    auto deg2b = 10_deg;
+    deg2b.normalize();
+    assert_same( deg2b.angle(), 10 );
+    assert_same( ( -10_deg ).normalized().angle(), -10 );
+
     auto deg3  = 450_deg;
     auto deg3n = deg3.normalized_abs();
     deg3.normalize_abs();
@@ -334,6 +358,76 @@ void normalize()
     assert_same( grad5.angle(), 0 );
 }
 
+struct bam16_conv
+{
+    constexpr static long double semicircle = 32768.0L;
+};
+
+struct half_deg_conv
+{
+    constexpr static long double semicircle = 180.5L;
+};
+
+void integer_normalize()
+{
+    static_assert( ideg( 270 ).normalized().angle() == -90, "constexpr normalize" );
+    static_assert( ideg( -540 ).normalized().angle() == -180, "constexpr normalize" );
+    static_assert( ideg( -90 ).normalized_abs().angle() == 270, "constexpr normalize_abs" );
+    static_assert( ideg( 720 ).normalized_abs().angle() == 0, "constexpr normalize_abs" );
+
+    // 16 bit binary angles with a power of two full circle
+    using bam = basic_angle< std::int16_t, bam16_conv >;
+    using ubam = basic_angle< std::uint16_t, bam16_conv >;
+    assert_true( bam( -32768 ).normalized().angle() == -32768 );
+    assert_true( bam( 32767 ).normalized().angle() == 32767 );
+    assert_true( ubam( 65535 ).normalized_abs().angle() == 65535 );
+    assert_true( ubam( 40000 ).normalized().angle() == 40000 ); // -25536 wraps back to the unsigned type
+
+    // Exact for 64 bit values that are not representable as doubles
+    using ldeg = basic_angle< std::int64_t, deg_conv >;
+    const std::int64_t big = ( std::int64_t( 1 ) << 60 ) + 1;
+    assert_true( ldeg( big ).normalized().angle() == static_cast< std::int64_t >( big % 360 ) );
+    assert_true( ldeg( -big ).normalized_abs().angle() == 360 - static_cast< std::int64_t >( big % 360 ) );
+
+    // Unsigned 64 bit values from 2^63 on are divided as unsigned values
+    using udeg = basic_angle< std::uint64_t, deg_conv >;
+    assert_true( udeg( ~std::uint64_t( 0 ) ).normalized_abs().angle() == 15 );
+    assert_true( udeg( ~std::uint64_t( 0 ) ).normalized().angle() == 15 );
+    assert_true( udeg( ( std::uint64_t( 1 ) << 63 ) + 100 ).normalized_abs().angle() == ( ( std::uint64_t( 1 ) << 63 ) + 100 ) % 360 );
+
+    // Same results as the floating point path for values exactly representable as doubles
+    using half_ideg = basic_angle< int, half_deg_conv >;
+    using half_deg  = basic_angle< double, half_deg_conv >;
+    bool same = true;
+    for( int i = -2000 ; i <= 2000 ; ++i )
+    {
+        same = same && ideg( i ).normalized().angle() == static_cast< int >( deg( i ).normalized().angle() );
+        same = same && ideg( i ).normalized_abs().angle() == static_cast< int >( deg( i ).normalized_abs().angle() );
+        same = same && half_ideg( i ).normalized().angle() == static_cast< int >( half_deg( i ).normalized().angle() );
+        same = same && half_ideg( i ).normalized_abs().angle() == static_cast< int >( half_deg( i ).normalized_abs().angle() );
+    }
+    assert_true( same );
+
+    // Batch forms
+    std::int16_t values[ 5 ] = { -1000, -180, 181, 359, 32767 };
+    basic_angle< std::int16_t, deg_conv > angles[ 5 ], normalized_angles[ 5 ], normalized_abs_angles[ 5 ];
+    for( std::size_t i = 0 ; i < 5 ; ++i )
+    {
+        angles[ i ] = basic_angle< std::int16_t, deg_conv >( values[ i ] );
+    }
+    normalized( angles, 5, normalized_angles );
+    normalized_abs( angles, 5, normalized_abs_angles );
+    for( std::size_t i = 0 ; i < 5 ; ++i )
+    {
+        assert_true( normalized_angles[ i ].angle() == angles[ i ].normalized().angle() );
+        assert_true( normalized_abs_angles[ i ].angle() == angles[ i ].normalized_abs().angle() );
+    }
+    normalize( angles, 5 );
+    assert_true( angles[ 0 ].angle() == 80 && angles[ 1 ].angle() == -180 && angles[ 2 ].angle() == -179 && angles[ 4 ].angle() == 7 );
+    normalize_abs( angles, 5 );
+    assert_true( angles[ 0 ].angle() == 80 && angles[ 1 ].angle() == 180 && angles[ 2 ].angle() == 181 && angles[ 3 ].angle() == 359 );
+}
+
 void angle_ceil()
 {
     using namespace pg::math::trigonometric_literals;
@@ -465,6 +559,1392 @@ void atan2()
     assert_same( atan2_grad_1.angle(), 50 );
 }
 
+void batch_inverse()
+{
+    double values[ 41 ];
+    double x[ 41 ];
+    for( int i = 0 ; i < 41 ; ++i )
+    {
+        values[ i ] = ( i - 20 ) / 20.0;
+        x[ i ]      = 20.0 - i * 1.5;
+    }
+
+    deg  asin_deg[ 41 ];
+    rad  acos_rad[ 41 ];
+    grad atan_grad[ 41 ];
+    deg  atan2_deg[ 41 ];
+    pg::math::asin< deg >( values, 41, asin_deg );
+    pg::math::acos( values, 41, acos_rad );
+    pg::math::atan< grad >( x, 41, atan_grad );
+    pg::math::atan2< deg >( values, x, 41, atan2_deg );
+
+    bool asin_same  = true;
+    bool acos_same  = true;
+    bool atan_same  = true;
+    bool atan2_same = true;
+    for( int i = 0 ; i < 41 ; ++i )
+    {
+        asin_same  &= std::abs( asin_deg[ i ].angle() - pg::math::asin< deg >( values[ i ] ).angle() ) < 1e-12;
+        acos_same  &= std::abs( acos_rad[ i ].angle() - pg::math::acos( values[ i ] ).angle() ) < 1e-14;
+        atan_same  &= std::abs( atan_grad[ i ].angle() - pg::math::atan< grad >( x[ i ] ).angle() ) < 1e-12;
+        atan2_same &= std::abs( atan2_deg[ i ].angle() - pg::math::atan2< deg >( values[ i ], x[ i ] ).angle() ) < 1e-12;
+    }
+    assert_true( asin_same );
+    assert_true( acos_same );
+    assert_true( atan_same );
+    assert_true( atan2_same );
+
+    const double y2[ 6 ] = { 0.0, 1.0, 1.0, 0.0, -1.0, -0.0 };
+    const double x2[ 6 ] = { 1.0, 1.0, 0.0, -1.0, -1.0, -1.0 };
+    deg quadrants[ 6 ];
+    pg::math::atan2< deg >( y2, x2, 6, quadrants );
+    assert_same( quadrants[ 0 ].angle(), 0.0 );
+    assert_same( quadrants[ 1 ].angle(), 45.0 );
+    assert_same( quadrants[ 2 ].angle(), 90.0 );
+    assert_same( quadrants[ 3 ].angle(), 180.0 );
+    assert_same( quadrants[ 4 ].angle(), -135.0 );
+    assert_same( quadrants[ 5 ].angle(), -180.0 );
+
+    // Integral angle types are rounded to the nearest value instead of truncated
+    const double halves[ 4 ] = { 0.5, 0.999, -0.999, -0.5 };
+    ideg acos_ideg[ 4 ];
+    pg::math::acos< ideg >( halves, 4, acos_ideg );
+    assert_true( acos_ideg[ 0 ].angle() == 60 );
+    assert_true( acos_ideg[ 1 ].angle() == 3 );
+    assert_true( acos_ideg[ 2 ].angle() == 177 );
+    assert_true( acos_ideg[ 3 ].angle() == 120 );
+
+    // NaN results of integral angle types are 0 and the results beyond their range saturate
+    const double outside[ 3 ] = { 2.0, -1.5, std::numeric_limits< double >::quiet_NaN() };
+    ideg asin_ideg[ 3 ];
+    pg::math::asin< ideg >( outside, 3, asin_ideg );
+    assert_true( asin_ideg[ 0 ].angle() == 0 );
+    assert_true( asin_ideg[ 1 ].angle() == 0 );
+    assert_true( asin_ideg[ 2 ].angle() == 0 );
+
+    using i8deg = basic_angle< std::int8_t, deg_conv >;
+    const double y3[ 3 ] = { 0.0, 1.0, -0.0 };
+    const double x3[ 3 ] = { -1.0, 0.0, -1.0 };
+    i8deg atan2_i8deg[ 3 ];
+    pg::math::atan2< i8deg >( y3, x3, 3, atan2_i8deg );
+    assert_true( atan2_i8deg[ 0 ].angle() == 127 );
+    assert_true( atan2_i8deg[ 1 ].angle() == 90 );
+    assert_true( atan2_i8deg[ 2 ].angle() == -128 );
+}
+
+struct fast_deg_conv
+{
+    constexpr static long double semicircle = 180.0;
+    using precision = pg::math::fast;
+};
+
+using fast_deg = basic_angle< double, fast_deg_conv >;
+
+constexpr long double pi_ld = 3.141592653589793238462643383279502884L;
+
+template< typename P, typename ANGLE >
+bool within_error_bounds( double range )
+{
+    constexpr int count = 2001;
+
+    ANGLE  angles[ count ];
+    double y[ count ];
+    double x[ count ];
+    for( int i = 0 ; i < count ; ++i )
+    {
+        angles[ i ] = ANGLE( static_cast< typename ANGLE::value_type >( -range + 2.0 * range * i / ( count - 1 ) ) );
+        y[ i ]      = std::sin( i * 0.37 ) * ( i % 5 );
+        x[ i ]      = std::cos( i * 0.51 ) * ( i % 3 );
+    }
+
+    double sin_batch[ count ];
+    double cos_batch[ count ];
+    double tan_batch[ count ];
+    rad    atan2_batch[ count ];
+    pg::math::sincos< P >( angles, count, sin_batch, cos_batch );
+    pg::math::tan< P >( angles, count, tan_batch );
+    pg::math::atan2< rad, P >( y, x, count, atan2_batch );
+
+    bool within = true;
+    for( int i = 0 ; i < count ; ++i )
+    {
+        const auto radians = angles[ i ].angle() * pi_ld / ANGLE::conversion::semicircle;
+        const auto s       = std::sin( radians );
+        const auto c       = std::cos( radians );
+        const auto t_bound = 2.0 * P::max_error * ( 1.0 + s * s / ( c * c ) );
+
+        within &= std::abs( pg::math::sin< P >( angles[ i ] ) - s ) < P::max_error;
+        within &= std::abs( pg::math::cos< P >( angles[ i ] ) - c ) < P::max_error;
+        within &= std::abs( c ) < 1e-9 || std::abs( pg::math::tan< P >( angles[ i ] ) - s / c ) < t_bound;
+        within &= std::abs( sin_batch[ i ] - s ) < P::max_error;
+        within &= std::abs( cos_batch[ i ] - c ) < P::max_error;
+        within &= std::abs( c ) < 1e-9 || std::abs( tan_batch[ i ] - s / c ) < t_bound;
+        within &= std::abs( pg::math::atan2< rad, P >( y[ i ], x[ i ] ).angle() - std::atan2( y[ i ], x[ i ] ) ) < P::max_error;
+        within &= std::abs( atan2_batch[ i ].angle() - std::atan2( y[ i ], x[ i ] ) ) < P::max_error;
+    }
+
+    return within;
+}
+
+void precision_policies()
+{
+    assert_true( ( within_error_bounds< fast, deg >( 720.0 ) ) );
+    assert_true( ( within_error_bounds< fast, rad >( 20.0 ) ) );
+    assert_true( ( within_error_bounds< fast, grad >( 1000.0 ) ) );
+    assert_true( ( within_error_bounds< fast, ideg >( 100000.0 ) ) );
+    assert_true( ( within_error_bounds< fastest, deg >( 720.0 ) ) );
+    assert_true( ( within_error_bounds< fastest, rad >( 20.0 ) ) );
+    assert_true( ( within_error_bounds< fastest, ideg >( 100000.0 ) ) );
+
+    // The batch functions of the precise policy use polynomials instead of the standard library
+    constexpr int count = 4001;
+    deg    angles[ count ];
+    double sin_batch[ count ];
+    double cos_batch[ count ];
+    for( int i = 0 ; i < count ; ++i )
+    {
+        angles[ i ] = deg( -1000.0 + i * 0.5 );
+    }
+    pg::math::sincos( angles, count, sin_batch, cos_batch );
+
+    bool precise_within = true;
+    for( int i = 0 ; i < count ; ++i )
+    {
+        const auto radians = angles[ i ].angle() * pi_ld / 180.0L;
+        precise_within &= std::abs( sin_batch[ i ] - std::sin( radians ) ) < precise::max_error;
+        precise_within &= std::abs( cos_batch[ i ] - std::cos( radians ) ) < precise::max_error;
+    }
+    assert_true( precise_within );
+
+    // Radians are reduced by the exact pi / 2 up to the end of the domain of the kernels, 2^20 quarter circles
+    rad    radians[ count ];
+    double sin_radians[ count ];
+    double cos_radians[ count ];
+    for( int i = 0 ; i < count ; ++i )
+    {
+        radians[ i ] = rad( ( i - count / 2 ) * 823.1 + i * 1e-3 );
+    }
+    pg::math::sincos( radians, count, sin_radians, cos_radians );
+
+    bool radians_within = true;
+    for( int i = 0 ; i < count ; ++i )
+    {
+        radians_within &= std::abs( sin_radians[ i ] - std::sin( radians[ i ].angle() ) ) < precise::max_error;
+        radians_within &= std::abs( cos_radians[ i ] - std::cos( radians[ i ].angle() ) ) < precise::max_error;
+    }
+    assert_true( radians_within );
+
+    // Inputs outside the domain of the kernels are computed by the standard library
+    const rad large[ 2 ] = { rad( 1e12 ), rad( -3e9 ) };
+    double    large_sin[ 2 ];
+    pg::math::sin< fast >( large, 2, large_sin );
+    assert_same( large_sin[ 0 ], pg::math::sin( large[ 0 ] ) );
+    assert_same( large_sin[ 1 ], pg::math::sin( large[ 1 ] ) );
+    assert_same( pg::math::cos< fastest >( large[ 0 ] ), pg::math::cos( large[ 0 ] ) );
+
+    // The policy of a conversion object is used when no policy is passed
+    const auto f = fast_deg( 30.0 );
+    assert_true( pg::math::sin( f ) == pg::math::sin< fast >( deg( 30.0 ) ) );
+    assert_true( pg::math::sin< precise >( f ) == pg::math::sin( deg( 30.0 ) ) );
+    assert_true( ( pg::math::atan2< fast_deg >( 1.0, 1.0 ).angle() == pg::math::atan2< deg, fast >( 1.0, 1.0 ).angle() ) );
+    assert_true( std::abs( pg::math::sin( f ) - 0.5 ) < fast::max_error );
+}
+
+void unwrapped()
+{
+    using namespace pg::math::trigonometric_literals;
+
+    const unwrapped_deg u1( 1000_deg );
+    assert_true( u1.revolutions() == 2 );
+    assert_same( u1.fraction().angle(), 280.0 );
+    assert_same( u1.angle().angle(), 1000.0 );
+
+    const unwrapped_deg u2( -90_deg );
+    assert_true( u2.revolutions() == -1 );
+    assert_same( u2.fraction().angle(), 270.0 );
+
+    const unwrapped_deg u3( 5, 400_deg );
+    assert_true( u3.revolutions() == 6 );
+    assert_same( u3.fraction().angle(), 40.0 );
+
+    const auto u4 = u1 + u3;
+    assert_true( u4.revolutions() == 8 );
+    assert_same( u4.fraction().angle(), 320.0 );
+
+    const auto u5 = u1 - u3;
+    assert_true( u5.revolutions() == -4 );
+    assert_same( u5.fraction().angle(), 240.0 );
+
+    auto u6 = u1;
+    u6 += 90_deg;
+    assert_true( u6.revolutions() == 3 );
+    assert_same( u6.fraction().angle(), 10.0 );
+    u6 -= 20_deg;
+    assert_true( u6.revolutions() == 2 );
+    assert_same( u6.fraction().angle(), 350.0 );
+
+    const auto u7 = -u1;
+    assert_true( u7.revolutions() == -3 );
+    assert_same( u7.fraction().angle(), 80.0 );
+    assert_true( u7 < u1 );
+    assert_true( u1 > u7 );
+    assert_true( u1 == unwrapped_deg( 2, 280_deg ) );
+    assert_true( u1 != u3 );
+
+    // The fraction keeps its precision when many revolutions are accumulated
+    unwrapped_rad odometer;
+    const rad     step( 0.1 );
+    for( int i = 0 ; i < 1000000 ; ++i )
+    {
+        odometer += step;
+    }
+    assert_true( odometer.revolutions() == 15915 );
+    assert_true( std::abs( odometer.fraction().angle() - std::fmod( 100000.0, 2.0 * pi ) ) < 1e-9 );
+
+    const auto u8 = angle_cast< unwrapped_grad >( u1 );
+    assert_true( u8.revolutions() == 2 );
+    assert_same( u8.fraction().angle(), 280.0 / 0.9 );
+    assert_same( sin( u1 ), sin( 280_deg ) );
+    assert_same( cos< fast >( u1 ), cos< fast >( 280_deg ) );
+
+    using unwrapped_ideg = basic_unwrapped_angle< int, deg_conv >;
+    const unwrapped_ideg i1( ideg( -725 ) );
+    assert_true( i1.revolutions() == -3 );
+    assert_true( i1.fraction().angle() == 355 );
+    assert_true( ( i1 + unwrapped_ideg( ideg( 10 ) ) ).revolutions() == -2 );
+
+    // Encoder readings that wrap forward, back and forward again
+    const deg samples[ 9 ] = { 350_deg, 355_deg, 2_deg, 10_deg, 358_deg, 340_deg, 359_deg, 1_deg, 721_deg };
+    unwrapped_deg result[ 9 ];
+    const auto last = unwrap( samples, 6, result );
+    assert_true( last == result[ 5 ] );
+    const auto next = unwrap( samples + 6, 3, result + 6, last );
+    assert_true( next == result[ 8 ] );
+
+    const double expected[ 9 ] = { 350, 355, 362, 370, 358, 340, 359, 361, 361 };
+    bool same = true;
+    for( int i = 0 ; i < 9 ; ++i )
+    {
+        same &= std::abs( result[ i ].angle().angle() - expected[ i ] ) < 1e-12;
+    }
+    assert_true( same );
+}
+
+template< axis_order ORDER >
+bool rotation_round_trip()
+{
+    using namespace pg::math::trigonometric_literals;
+
+    const auto r = to_rotation_matrix< ORDER >( 30_deg, -20_deg, 110_deg );
+    const auto q = to_quaternion< ORDER >( 30_deg, -20_deg, 110_deg );
+    const auto e = to_euler_angles< ORDER, deg >( r );
+    const auto f = to_euler_angles< ORDER, deg >( q );
+
+    return std::abs( e.first.angle() - 30.0 ) < 1e-12 && std::abs( e.second.angle() + 20.0 ) < 1e-12 && std::abs( e.third.angle() - 110.0 ) < 1e-12 &&
+           std::abs( f.first.angle() - 30.0 ) < 1e-12 && std::abs( f.second.angle() + 20.0 ) < 1e-12 && std::abs( f.third.angle() - 110.0 ) < 1e-12;
+}
+
+void rotation()
+{
+    using namespace pg::math::trigonometric_literals;
+
+    // Yaw, pitch and roll against the product of the elementary rotations
+    const double y = 30.0 * pi / 180.0, p = 20.0 * pi / 180.0, l = 10.0 * pi / 180.0;
+    const double rz[ 3 ][ 3 ] = { { std::cos( y ), -std::sin( y ), 0.0 }, { std::sin( y ), std::cos( y ), 0.0 }, { 0.0, 0.0, 1.0 } };
+    const double ry[ 3 ][ 3 ] = { { std::cos( p ), 0.0, std::sin( p ) }, { 0.0, 1.0, 0.0 }, { -std::sin( p ), 0.0, std::cos( p ) } };
+    const double rx[ 3 ][ 3 ] = { { 1.0, 0.0, 0.0 }, { 0.0, std::cos( l ), -std::sin( l ) }, { 0.0, std::sin( l ), std::cos( l ) } };
+
+    const auto r = to_rotation_matrix< axis_order::zyx >( 30_deg, 20_deg, 10_deg );
+    const auto m = to_rotation_matrix( to_quaternion< axis_order::zyx >( 30_deg, 20_deg, 10_deg ) );
+    bool same = true;
+    for( int i = 0 ; i < 3 ; ++i )
+    {
+        for( int j = 0 ; j < 3 ; ++j )
+        {
+            double expected = 0.0;
+            for( int k = 0 ; k < 3 ; ++k )
+            {
+                for( int n = 0 ; n < 3 ; ++n )
+                {
+                    expected += rz[ i ][ k ] * ry[ k ][ n ] * rx[ n ][ j ];
+                }
+            }
+            same &= std::abs( r.m[ i ][ j ] - expected ) < 1e-15 && std::abs( m.m[ i ][ j ] - expected ) < 1e-15;
+        }
+    }
+    assert_true( same );
+
+    assert_true( rotation_round_trip< axis_order::xyz >() );
+    assert_true( rotation_round_trip< axis_order::xzy >() );
+    assert_true( rotation_round_trip< axis_order::yxz >() );
+    assert_true( rotation_round_trip< axis_order::yzx >() );
+    assert_true( rotation_round_trip< axis_order::zxy >() );
+    assert_true( rotation_round_trip< axis_order::zyx >() );
+
+    // In gimbal lock the first and third rotation are about the same axis so only their sum or difference is preserved
+    const auto locked = to_euler_angles< axis_order::zyx, deg >( to_rotation_matrix< axis_order::zyx >( 50_deg, 90_deg, 20_deg ) );
+    assert_true( std::abs( locked.first.angle() - 30.0 ) < 1e-6 );
+    assert_true( std::abs( locked.second.angle() - 90.0 ) < 1e-6 );
+    assert_same( locked.third.angle(), 0.0 );
+
+    const auto ilocked = to_euler_angles< axis_order::xyz, ideg >( to_rotation_matrix< axis_order::xyz >( 50_deg, -90_deg, 20_deg ) );
+    assert_true( ilocked.first.angle() == 30 && ilocked.second.angle() == -90 && ilocked.third.angle() == 0 );
+
+    // Batch conversions against the scalar conversions
+    constexpr std::size_t count = 300;
+    std::vector< deg > first( count ), second( count ), third( count );
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        first[ i ]  = deg( -180.0 + 1.2 * static_cast< double >( i ) );
+        second[ i ] = deg( -89.0 + 0.59 * static_cast< double >( i ) );
+        third[ i ]  = deg( 179.0 - 1.1 * static_cast< double >( i ) );
+    }
+
+    std::vector< double > elements( 9 * count ), components( 4 * count );
+    rotation_matrix_arrays<> matrices;
+    for( int i = 0 ; i < 9 ; ++i )
+    {
+        matrices.m[ i / 3 ][ i % 3 ] = elements.data() + i * count;
+    }
+    const quaternion_arrays<> quaternions = { components.data(), components.data() + count, components.data() + 2 * count, components.data() + 3 * count };
+
+    to_rotation_matrices< axis_order::yxz >( first.data(), second.data(), third.data(), count, matrices );
+    to_quaternions< axis_order::yxz >( first.data(), second.data(), third.data(), count, quaternions );
+
+    double matrix_error     = 0.0;
+    double quaternion_error = 0.0;
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        const auto ri = to_rotation_matrix< axis_order::yxz >( first[ i ], second[ i ], third[ i ] );
+        const auto qi = to_quaternion< axis_order::yxz >( first[ i ], second[ i ], third[ i ] );
+        for( int k = 0 ; k < 9 ; ++k )
+        {
+            matrix_error = std::max( matrix_error, std::abs( matrices.m[ k / 3 ][ k % 3 ][ i ] - ri.m[ k / 3 ][ k % 3 ] ) );
+        }
+        quaternion_error = std::max( { quaternion_error, std::abs( quaternions.w[ i ] - qi.w ), std::abs( quaternions.x[ i ] - qi.x ),
+                                       std::abs( quaternions.y[ i ] - qi.y ), std::abs( quaternions.z[ i ] - qi.z ) } );
+    }
+    assert_true( matrix_error < 1e-15 );
+    assert_true( quaternion_error < 1e-15 );
+
+    rotation_matrix_arrays< const double > input;
+    for( int i = 0 ; i < 9 ; ++i )
+    {
+        input.m[ i / 3 ][ i % 3 ] = matrices.m[ i / 3 ][ i % 3 ];
+    }
+    const quaternion_arrays< const double > qinput = { quaternions.w, quaternions.x, quaternions.y, quaternions.z };
+
+    std::vector< deg > e1( count ), e2( count ), e3( count ), f1( count ), f2( count ), f3( count );
+    to_euler_angles< axis_order::yxz, deg >( input, count, e1.data(), e2.data(), e3.data() );
+    to_euler_angles< axis_order::yxz, deg, fast >( qinput, count, f1.data(), f2.data(), f3.data() );
+
+    const auto distance = []( deg a, deg b ) { return std::abs( std::remainder( ( a - b ).angle(), 360.0 ) ); };
+    double error      = 0.0;
+    double fast_error = 0.0;
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        error      = std::max( { error, distance( e1[ i ], first[ i ] ), distance( e2[ i ], second[ i ] ), distance( e3[ i ], third[ i ] ) } );
+        fast_error = std::max( { fast_error, distance( f1[ i ], first[ i ] ), distance( f3[ i ], third[ i ] ) } );
+    }
+    assert_true( error < 1e-9 );
+    assert_true( fast_error < 1e-5 );
+
+    // The scalar conversion applies the precision policy to all three angles, as the batch conversion does
+    to_euler_angles< axis_order::yxz, deg, fast >( input, count, f1.data(), f2.data(), f3.data() );
+    auto scalar_same = true;
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        rotation_matrix ri;
+        for( int k = 0 ; k < 9 ; ++k )
+        {
+            ri.m[ k / 3 ][ k % 3 ] = input.m[ k / 3 ][ k % 3 ][ i ];
+        }
+        const auto ei = to_euler_angles< axis_order::yxz, deg, fast >( ri );
+        scalar_same = scalar_same && ei.first.angle() == f1[ i ].angle() && ei.second.angle() == f2[ i ].angle() && ei.third.angle() == f3[ i ].angle();
+    }
+    assert_true( scalar_same );
+}
+
+void geodesy()
+{
+    using namespace pg::math::trigonometric_literals;
+
+    // Paris to New York
+    const deg latitude[ 2 ]  = { 48.8566_deg, 40.7128_deg };
+    const deg longitude[ 2 ] = { 2.3522_deg, -74.006_deg };
+    double d[ 4 ];
+    distance_matrix( latitude, longitude, 2, latitude, longitude, 2, d, 6371.0 );
+    assert_true( std::abs( d[ 1 ] - 5837.24 ) < 0.01 );
+    assert_same( d[ 1 ], d[ 2 ] );
+    assert_true( d[ 0 ] == 0.0 && d[ 3 ] == 0.0 );
+
+    // Points one meter apart keep their precision
+    const deg near_latitude[ 2 ]  = { 10_deg, deg( 10.0 + 180.0 / pi / mean_earth_radius ) };
+    const deg near_longitude[ 2 ] = { 20_deg, 20_deg };
+    distance_matrix( near_latitude, near_longitude, 1, near_latitude + 1, near_longitude + 1, 1, d );
+    assert_true( std::abs( d[ 0 ] - 1.0 ) < 1e-8 );
+
+    constexpr std::size_t count       = 37;
+    constexpr std::size_t other_count = 1100;
+    std::vector< deg > lat( count ), lon( count ), other_lat( other_count ), other_lon( other_count );
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        lat[ i ] = deg( -80.0 + 4.3 * static_cast< double >( i ) );
+        lon[ i ] = deg( -179.0 + 9.7 * static_cast< double >( i ) );
+    }
+    for( std::size_t j = 0 ; j < other_count ; ++j )
+    {
+        other_lat[ j ] = deg( std::fmod( 0.77 * static_cast< double >( j * j ), 180.0 ) - 90.0 );
+        other_lon[ j ] = deg( std::fmod( 3.1 * static_cast< double >( j ), 360.0 ) - 180.0 );
+    }
+
+    const auto reference = [ & ]( std::size_t i, std::size_t j )
+    {
+        const auto to_radians = pi_ld / 180.0L;
+        const auto dlat       = std::sin( ( other_lat[ j ].angle() - lat[ i ].angle() ) * to_radians / 2.0L );
+        const auto dlon       = std::sin( ( other_lon[ j ].angle() - lon[ i ].angle() ) * to_radians / 2.0L );
+        const auto h          = dlat * dlat + std::cos( lat[ i ].angle() * to_radians ) * std::cos( other_lat[ j ].angle() * to_radians ) * dlon * dlon;
+        return static_cast< double >( 2.0L * std::asin( std::sqrt( h ) ) );
+    };
+
+    std::vector< double > matrix( count * other_count ), fast_matrix( count * other_count );
+    distance_matrix( lat.data(), lon.data(), count, other_lat.data(), other_lon.data(), other_count, matrix.data(), 1.0, 3 );
+    distance_matrix< fast >( lat.data(), lon.data(), count, other_lat.data(), other_lon.data(), other_count, fast_matrix.data(), 1.0, 1 );
+
+    double error      = 0.0;
+    double fast_error = 0.0;
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        for( std::size_t j = 0 ; j < other_count ; ++j )
+        {
+            error      = std::max( error, std::abs( matrix[ i * other_count + j ] - reference( i, j ) ) );
+            // Near antipodal points the chord length is insensitive to the distance
+            if( reference( i, j ) < 2.0 )
+            {
+                fast_error = std::max( fast_error, std::abs( fast_matrix[ i * other_count + j ] - reference( i, j ) ) );
+            }
+        }
+    }
+    assert_true( error < 1e-13 );
+    assert_true( fast_error < 1e-6 );
+
+    constexpr std::size_t k = 5;
+    std::vector< std::size_t > indices( count * k );
+    std::vector< double >      distances( count * k );
+    nearest( lat.data(), lon.data(), count, other_lat.data(), other_lon.data(), other_count, k, indices.data(), distances.data(), 1.0, 4 );
+
+    bool same = true;
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        std::vector< double > row( matrix.begin() + static_cast< std::ptrdiff_t >( i * other_count ), matrix.begin() + static_cast< std::ptrdiff_t >( ( i + 1 ) * other_count ) );
+        std::sort( row.begin(), row.end() );
+        for( std::size_t n = 0 ; n < k ; ++n )
+        {
+            same &= distances[ i * k + n ] == row[ n ] && matrix[ i * other_count + indices[ i * k + n ] ] == row[ n ];
+        }
+    }
+    assert_true( same );
+
+    std::size_t few[ 3 ];
+    nearest( lat.data(), lon.data(), 1, other_lat.data(), other_lon.data(), 2, 3, few, d );
+    assert_true( few[ 2 ] == 2 && std::isinf( d[ 2 ] ) );
+
+    const auto matches = within_distance( lat.data(), lon.data(), count, other_lat.data(), other_lon.data(), other_count, 0.3, 1.0, 2 );
+    std::vector< distance_match > expected;
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        for( std::size_t j = 0 ; j < other_count ; ++j )
+        {
+            if( matrix[ i * other_count + j ] <= 0.3 )
+            {
+                expected.push_back( { i, j, matrix[ i * other_count + j ] } );
+            }
+        }
+    }
+    assert_true( !expected.empty() && matches.size() == expected.size() );
+    assert_true( std::equal( matches.begin(), matches.end(), expected.begin(), expected.end(), []( const distance_match & a, const distance_match & b )
+    {
+        return a.index == b.index && a.other_index == b.other_index && a.distance == b.distance;
+    } ) );
+    assert_true( within_distance( lat.data(), lon.data(), count, other_lat.data(), other_lon.data(), other_count, 4.0, 1.0 ).size() == count * other_count );
+}
+
+void bearing_destination()
+{
+    using namespace pg::math::trigonometric_literals;
+
+    // Due east on the equator, due north and the initial bearing from Paris to New York
+    const deg latitude[ 3 ]        = { 0_deg, 10_deg, 48.8566_deg };
+    const deg longitude[ 3 ]       = { 0_deg, 20_deg, 2.3522_deg };
+    const deg other_latitude[ 3 ]  = { 0_deg, 30_deg, 40.7128_deg };
+    const deg other_longitude[ 3 ] = { 90_deg, 20_deg, -74.006_deg };
+
+    deg bearings[ 3 ];
+    initial_bearing< deg >( latitude, longitude, other_latitude, other_longitude, 3, bearings );
+    assert_same( bearings[ 0 ].angle(), 90.0 );
+    assert_same( bearings[ 1 ].angle(), 0.0 );
+    assert_true( std::abs( bearings[ 2 ].angle() - 291.79386 ) < 1e-5 );
+
+    ideg ibearings[ 3 ];
+    initial_bearing< ideg >( other_latitude, other_longitude, latitude, longitude, 3, ibearings );
+    assert_true( ibearings[ 0 ].angle() == 270 && ibearings[ 1 ].angle() == 180 && ibearings[ 2 ].angle() == 54 );
+
+    // Travelling the distance along the initial bearing arrives at the other point
+    constexpr std::size_t count = 500;
+    std::vector< deg > lat( count ), lon( count ), other_lat( count ), other_lon( count ), bearing( count ), result_lat( count ), result_lon( count );
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        lat[ i ]       = deg( std::fmod( 0.37 * static_cast< double >( i * i ), 170.0 ) - 85.0 );
+        lon[ i ]       = deg( std::fmod( 7.3 * static_cast< double >( i ), 360.0 ) - 180.0 );
+        other_lat[ i ] = deg( 80.0 - 0.31 * static_cast< double >( i ) );
+        other_lon[ i ] = deg( std::fmod( 2.9 * static_cast< double >( i * i ), 360.0 ) - 180.0 );
+    }
+
+    std::vector< double > distance( count );
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        distance_matrix( &lat[ i ], &lon[ i ], 1, &other_lat[ i ], &other_lon[ i ], 1, &distance[ i ], mean_earth_radius, 1 );
+    }
+
+    initial_bearing< deg >( lat.data(), lon.data(), other_lat.data(), other_lon.data(), count, bearing.data() );
+    destination< deg >( lat.data(), lon.data(), bearing.data(), distance.data(), count, result_lat.data(), result_lon.data() );
+
+    double error = 0.0;
+    bool   range = true;
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        error = std::max( { error, std::abs( result_lat[ i ].angle() - other_lat[ i ].angle() ),
+                                   std::abs( std::remainder( result_lon[ i ].angle() - other_lon[ i ].angle(), 360.0 ) ) } );
+        range &= bearing[ i ].angle() >= 0.0 && bearing[ i ].angle() < 360.0 && std::abs( result_lon[ i ].angle() ) <= 180.0;
+    }
+    assert_true( error < 1e-9 );
+    assert_true( range );
+
+    // 1000 km north of the equator in radians with the fast policy
+    rad north[ 1 ];
+    rad east[ 1 ];
+    const double thousand_km[ 1 ] = { 1000000.0 };
+    destination< rad, fast >( latitude, longitude, bearings + 1, thousand_km, 1, north, east );
+    assert_true( std::abs( north[ 0 ].angle() - 1000000.0 / mean_earth_radius ) < 1e-7 );
+    assert_true( std::abs( east[ 0 ].angle() ) < 1e-7 );
+
+    // The angular distances use the precision policy of the start points like their coordinates
+    std::vector< fast_deg > fast_lat( count ), fast_lon( count ), fast_bearing( count ), fast_result_lat( count ), fast_result_lon( count ),
+                            policy_lat( count ), policy_lon( count );
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        fast_lat[ i ]     = fast_deg( lat[ i ].angle() );
+        fast_lon[ i ]     = fast_deg( lon[ i ].angle() );
+        fast_bearing[ i ] = fast_deg( bearing[ i ].angle() );
+    }
+    destination< fast_deg >( fast_lat.data(), fast_lon.data(), fast_bearing.data(), distance.data(), count, fast_result_lat.data(), fast_result_lon.data() );
+    destination< fast_deg, fast >( lat.data(), lon.data(), bearing.data(), distance.data(), count, policy_lat.data(), policy_lon.data() );
+
+    bool same_policy = true;
+    for( std::size_t i = 0 ; i < count ; ++i )
+    {
+        same_policy &= fast_result_lat[ i ].angle() == policy_lat[ i ].angle() && fast_result_lon[ i ].angle() == policy_lon[ i ].angle();
+    }
+    assert_true( same_policy );
+}
+
+struct native_conv
+{
+    constexpr static long double semicircle = 128.0L;
+    using precision    = fast;
+    using coefficients = semicircle128_fast_coefficients;
+};
+
+void native_coefficients()
+{
+    using native      = basic_angle< double, native_conv >;
+    using native_int  = basic_angle< std::int16_t, native_conv >;
+    using coefficients = semicircle128_fast_coefficients;
+
+    // The kernel evaluates the generated polynomials on the angle in its own unit
+    assert_true( sin( native( 10.0 ) ) == 10.0 * coefficients::sin( 100.0 ) );
+    assert_true( cos( native( -20.0 ) ) == coefficients::cos( 400.0 ) );
+
+    double sin_error = 0.0;
+    double cos_error = 0.0;
+    for( int i = -512 ; i <= 512 ; ++i )
+    {
+        const auto x = static_cast< long double >( i ) * pi_ld / 128.0L;
+        sin_error = std::max( sin_error, static_cast< double >( std::abs( sin( native_int( static_cast< std::int16_t >( i ) ) ) - std::sin( x ) ) ) );
+        cos_error = std::max( cos_error, static_cast< double >( std::abs( cos( native( i + 0.3 ) ) - std::cos( ( i + 0.3L ) * pi_ld / 128.0L ) ) ) );
+    }
+    // Both polynomials are used for each function depending on the quadrant
+    const auto max_error = std::max( coefficients::sin_error, coefficients::cos_error ) * 1.01 + 1e-16;
+    assert_true( sin_error <= max_error );
+    assert_true( cos_error <= max_error );
+
+    double atan_error = 0.0;
+    double batch_error = 0.0;
+    std::vector< double > y( 1000 ), x( 1000 );
+    std::vector< native > angles( 1000 );
+    for( std::size_t i = 0 ; i < y.size() ; ++i )
+    {
+        y[ i ] = std::sin( 0.0063 * static_cast< double >( i ) ) * 3.0;
+        x[ i ] = std::cos( 0.0063 * static_cast< double >( i ) ) * 3.0;
+    }
+    atan2< native >( y.data(), x.data(), y.size(), angles.data() );
+    for( std::size_t i = 0 ; i < y.size() ; ++i )
+    {
+        const auto expected = std::atan2( static_cast< long double >( y[ i ] ), x[ i ] ) * 128.0L / pi_ld;
+        atan_error  = std::max( atan_error, static_cast< double >( std::abs( atan2< native >( y[ i ], x[ i ] ).angle() - expected ) ) );
+        batch_error = std::max( batch_error, static_cast< double >( std::abs( angles[ i ].angle() - expected ) ) );
+    }
+    assert_true( atan_error * pi / 128.0 <= coefficients::atan_error * 1.01 + 1e-15 );
+    assert_true( batch_error == atan_error );
+
+    // Other policies are not affected by the coefficients
+    assert_same( sin< precise >( native( 32.0 ) ), std::sqrt( 0.5 ) );
+}
+
+void pipeline()
+{
+    using namespace pg::math::trigonometric_literals;
+
+    using deg_block = block< deg, 64 >;
+    using rad_block = block< rad, 64 >;
+
+    constexpr std::size_t blocks = 100;
+    const auto sample = []( std::size_t i ) { return deg( static_cast< double >( i ) * 7.3 - 20000.0 ); };
+
+    auto samples    = std::unique_ptr< spsc_ring< deg_block, 4 > >( new spsc_ring< deg_block, 4 >() );
+    auto normalized = std::unique_ptr< spsc_ring< deg_block, 4 > >( new spsc_ring< deg_block, 4 >() );
+    auto radians    = std::unique_ptr< spsc_ring< rad_block, 4 > >( new spsc_ring< rad_block, 4 >() );
+    auto results    = std::unique_ptr< spsc_ring< sincos_block< 64 >, 8 > >( new spsc_ring< sincos_block< 64 >, 8 >() );
+
+    std::thread producer( [ & ]()
+    {
+        for( std::size_t b = 0 ; b <= blocks ; ++b )
+        {
+            deg_block * out;
+            while( !( out = samples->acquire() ) )
+            {
+                std::this_thread::yield();
+            }
+
+            // The last block has no values and ends the stream
+            out->count    = b < blocks ? 64 - b % 3 : 0;
+            out->sequence = b;
+            for( std::size_t i = 0 ; i < out->count ; ++i )
+            {
+                out->values[ i ] = sample( b * 64 + i );
+            }
+            samples->commit();
+        }
+    } );
+
+    normalize_stage normalize;
+    cast_stage< rad > cast;
+    sincos_stage<>    sincos;
+    std::thread normalizer( [ & ]() { run_stage( normalize, *samples, *normalized ); } );
+    std::thread caster( [ & ]() { run_stage( cast, *normalized, *radians ); } );
+    std::thread evaluator( [ & ]() { run_stage( sincos, *radians, *results ); } );
+
+    bool          ordered = true;
+    double        error   = 0.0;
+    std::size_t   count   = 0;
+    std::uint64_t next    = 0;
+    for( ;; )
+    {
+        const sincos_block< 64 > * in;
+        while( !( in = results->front() ) )
+        {
+            std::this_thread::yield();
+        }
+
+        if( !in->count )
+        {
+            results->pop();
+            break;
+        }
+
+        ordered &= in->sequence == next++;
+        for( std::size_t i = 0 ; i < in->count ; ++i )
+        {
+            const auto x = sample( in->sequence * 64 + i );
+            error = std::max( { error, static_cast< double >( std::abs( in->sin[ i ] - sin( x ) ) ), static_cast< double >( std::abs( in->cos[ i ] - cos( x ) ) ) } );
+        }
+        count += in->count;
+        results->pop();
+    }
+
+    producer.join();
+    normalizer.join();
+    caster.join();
+    evaluator.join();
+
+    assert_true( ordered && next == blocks );
+    assert_true( count == 64 * blocks - 99 );
+    assert_true( error < 1e-13 );
+
+    // The unwrap stage carries the revolutions over the blocks
+    unwrap_stage< double, deg_conv > unwrap_samples;
+    block< deg, 4 >           in;
+    block< unwrapped_deg, 4 > out;
+    in.count = 4;
+    in.values[ 0 ] = 350_deg; in.values[ 1 ] = 10_deg; in.values[ 2 ] = 30_deg; in.values[ 3 ] = 340_deg;
+    unwrap_samples( in, out );
+    assert_same( out.values[ 1 ].angle().angle(), 370.0 );
+    in.values[ 0 ] = 20_deg; in.values[ 1 ] = 50_deg; in.count = 2;
+    unwrap_samples( in, out );
+    assert_same( out.values[ 0 ].angle().angle(), 380.0 );
+    assert_true( out.values[ 1 ].revolutions() == 1 );
+
+    spsc_ring< int, 2 > ring;
+    int value = 0;
+    assert_true( ring.try_push( 1 ) && ring.try_push( 2 ) && !ring.try_push( 3 ) );
+    assert_true( ring.try_pop( value ) && value == 1 && ring.try_pop( value ) && value == 2 && !ring.try_pop( value ) );
+}
+
+void interval_set()
+{
+    using namespace pg::math::trigonometric_literals;
+
+    // 0: field of view across 0°, 1: a sector, 2: the full circle, 3: inside the sector
+    const angular_interval_set< deg > set{ { 330_deg, 30_deg }, { 0_deg, 90_deg }, { -180_deg, 180_deg }, { 45_deg, 60_deg } };
+    assert_true( set.size() == 4 );
+
+    assert_true( ( set.containing( 0_deg ) == std::vector< std::size_t >{ 0, 1, 2 } ) );
+    assert_true( ( set.containing( 359_deg ) == std::vector< std::size_t >{ 0, 2 } ) );
+    assert_true( ( set.containing( -1_deg ) == std::vector< std::size_t >{ 0, 2 } ) );
+    assert_true( ( set.containing( 720_deg + 50_deg ) == std::vector< std::size_t >{ 1, 2, 3 } ) );
+    assert_true( ( set.containing( 30_deg ) == std::vector< std::size_t >{ 1, 2 } ) ); // The end is not included
+    assert_true( ( set.containing( 90_deg ) == std::vector< std::size_t >{ 2 } ) );
+    assert_true( set.count_containing( 45_deg ) == 3 );
+    assert_true( set.contains( 200_deg ) );
+
+    std::size_t visited = 0;
+    set.for_each_containing( 10_deg, [ & ]( std::size_t id ) { visited += id + 1; } );
+    assert_true( visited == 1 + 2 + 3 );
+
+    assert_true( ( set.overlapping( 100_deg, 320_deg ) == std::vector< std::size_t >{ 2 } ) );
+    assert_true( ( set.overlapping( 50_deg, 340_deg ) == std::vector< std::size_t >{ 0, 1, 2, 3 } ) );
+    assert_true( ( set.overlapping( 31_deg, 44_deg ) == std::vector< std::size_t >{ 1, 2 } ) );
+
+    const angular_interval_set< deg > empty;
+    assert_false( empty.contains( 10_deg ) );
+    assert_true( empty.containing( 10_deg ).empty() );
+
+    // Brute force comparison of the batch queries with sectors of integral degrees
+    using interval = angular_interval< ideg >;
+    std::vector< interval > sectors;
+    for( int i = 0 ; i < 40 ; ++i )
+    {
+        sectors.push_back( { ideg( i * 37 - 500 ), ideg( i * 53 + 17 ) } );
+    }
+    const angular_interval_set< ideg > sector_set( sectors.begin(), sectors.end() );
+
+    std::vector< ideg > angles;
+    for( int a = -720 ; a <= 720 ; ++a )
+    {
+        angles.push_back( ideg( a ) );
+    }
+    std::vector< std::size_t > counts( angles.size() );
+    sector_set.count_containing( angles.data(), angles.size(), counts.data() );
+    std::unique_ptr< bool[] > any( new bool[ angles.size() ] );
+    sector_set.contains( angles.data(), angles.size(), any.get() );
+
+    std::vector< std::size_t > found( angles.size() );
+    sector_set.for_each_containing( angles.data(), angles.size(), [ & ]( std::size_t a, std::size_t ) { ++found[ a ]; } );
+
+    bool same = true;
+    for( std::size_t a = 0 ; a < angles.size() ; ++a )
+    {
+        std::size_t expected = 0;
+        const auto value = angles[ a ].normalized_abs().angle();
+        for( const auto & sector : sectors )
+        {
+            const auto begin = sector.first.normalized_abs().angle();
+            const auto end   = sector.last.normalized_abs().angle();
+            expected += begin < end ? ( value >= begin && value < end ) : ( value >= begin || value < end );
+        }
+        same = same && counts[ a ] == expected && found[ a ] == expected && any[ a ] == ( expected != 0 );
+    }
+    assert_true( same );
+}
+
+template< typename T >
+bool same_distance( T a, T b )
+{
+    return std::abs( a - b ) < 1e-12;
+}
+
+template< typename ANGLE >
+bool circular_index_matches_brute_force( const std::vector< ANGLE > & catalogue, const std::vector< ANGLE > & queries, std::size_t k )
+{
+    using value_type = typename ANGLE::value_type;
+
+    const circular_index< ANGLE > index( catalogue.data(), catalogue.size() );
+    std::vector< angular_neighbour< ANGLE > > found( queries.size() * k );
+    index.nearest( queries.data(), queries.size(), k, found.data() );
+
+    bool same = true;
+    for( std::size_t q = 0 ; q < queries.size() ; ++q )
+    {
+        std::vector< value_type > expected;
+        for( const auto & c : catalogue )
+        {
+            const auto d = std::abs( ( c - queries[ q ] ).normalized().angle() );
+            expected.push_back( d );
+        }
+        std::sort( expected.begin(), expected.end() );
+
+        same = same && same_distance( index.nearest( queries[ q ] ).distance.angle(), expected.front() );
+        for( std::size_t i = 0 ; i < std::min( k, catalogue.size() ) ; ++i )
+        {
+            const auto & n = found[ q * k + i ];
+            same = same && same_distance( n.distance.angle(), expected[ i ] );
+            same = same && same_distance( std::abs( ( catalogue[ n.index ] - queries[ q ] ).normalized().angle() ), expected[ i ] );
+        }
+    }
+    return same;
+}
+
+void circular_nearest()
+{
+    using namespace pg::math::trigonometric_literals;
+
+    const deg catalogue[] = { 10_deg, 350_deg, 180_deg, -90_deg, 725_deg };
+    const circular_index< deg > index( catalogue, 5 );
+    assert_true( index.size() == 5 );
+
+    // Across the seam
+    assert_true( index.nearest( 352_deg ).index == 1 );
+    assert_same( index.nearest( 352_deg ).distance.angle(), 2.0 );
+    assert_true( index.nearest( -1_deg ).index == 4 );
+    assert_same( index.nearest( -1_deg ).distance.angle(), 6.0 );
+    assert_true( index.nearest( 200_deg ).index == 2 );
+
+    const auto three = index.nearest( 0_deg, 3 );
+    assert_true( three.size() == 3 && three[ 0 ].index == 4 && three[ 1 ].distance == 10_deg && three[ 2 ].distance == 10_deg );
+    assert_true( index.nearest( 0_deg, 9 ).size() == 5 );
+
+    angular_neighbour< deg > padded[ 7 ];
+    index.nearest( 0_deg, 7, padded );
+    assert_true( padded[ 3 ].index == 3 && padded[ 4 ].index == 2 && padded[ 5 ].index == 5 && std::isinf( padded[ 6 ].distance.angle() ) );
+
+    const circular_index< deg > empty;
+    assert_true( empty.nearest( 10_deg ).index == 0 && std::isinf( empty.nearest( 10_deg ).distance.angle() ) );
+
+    // Brute force comparisons
+    std::vector< deg >  catalogue_deg;
+    std::vector< ideg > catalogue_ideg;
+    for( int i = 0 ; i < 300 ; ++i )
+    {
+        catalogue_deg.push_back( deg( std::fmod( i * 137.035999, 1000.0 ) - 500.0 ) );
+        catalogue_ideg.push_back( ideg( ( i * 7919 ) % 2000 - 1000 ) );
+    }
+    std::vector< deg >  queries_deg;
+    std::vector< ideg > queries_ideg;
+    for( int i = -400 ; i < 400 ; i += 3 )
+    {
+        queries_deg.push_back( deg( i * 1.1 ) );
+        queries_ideg.push_back( ideg( i ) );
+    }
+    assert_true( circular_index_matches_brute_force( catalogue_deg, queries_deg, 4 ) );
+    assert_true( circular_index_matches_brute_force( catalogue_ideg, queries_ideg, 5 ) );
+    assert_true( circular_index_matches_brute_force( std::vector< ideg >( catalogue_ideg.begin(), catalogue_ideg.begin() + 7 ), queries_ideg, 9 ) );
+}
+
+template< typename ANGLE >
+bool radix_sort_matches_stable_sort( std::vector< ANGLE > angles, sort_key order, unsigned threads )
+{
+    const auto less = [ order ]( ANGLE a, ANGLE b )
+    {
+        return order == sort_key::normalized ? a.normalized_abs() < b.normalized_abs() : a < b;
+    };
+
+    std::vector< std::size_t > expected( angles.size() );
+    std::iota( expected.begin(), expected.end(), std::size_t( 0 ) );
+    std::stable_sort( expected.begin(), expected.end(), [ & ]( std::size_t a, std::size_t b ) { return less( angles[ a ], angles[ b ] ); } );
+
+    std::vector< std::size_t > permutation( angles.size() );
+    radix_sort_permutation( angles.data(), angles.size(), permutation.data(), order, threads );
+
+    auto sorted = angles;
+    radix_sort( sorted.data(), sorted.size(), order, threads );
+
+    bool same = permutation == expected;
+    for( std::size_t i = 0 ; i < angles.size() ; ++i )
+    {
+        same = same && sorted[ i ].angle() == angles[ expected[ i ] ].angle();
+    }
+    return same;
+}
+
+void radix_sort_angles()
+{
+    using namespace pg::math::trigonometric_literals;
+
+    deg degrees[] = { 42_deg, -18_deg, 333_deg, 0_deg, -360_deg, 37_deg, -0.5_deg };
+    radix_sort( degrees, 7 );
+    assert_true( degrees[ 0 ] == -360_deg && degrees[ 1 ] == -18_deg && degrees[ 2 ] == -0.5_deg && degrees[ 6 ] == 333_deg );
+
+    radix_sort( degrees, 7, sort_key::normalized );
+    assert_true( degrees[ 0 ] == -360_deg && degrees[ 1 ] == 0_deg && degrees[ 4 ] == 333_deg && degrees[ 5 ] == -18_deg && degrees[ 6 ] == -0.5_deg );
+
+    std::vector< deg >                                  many_degrees;
+    std::vector< ideg >                                 many_idegrees;
+    std::vector< basic_angle< std::int16_t, deg_conv > > many_short;
+    std::vector< basic_angle< float, rad_conv > >       many_float;
+    std::uint64_t state = 7;
+    for( int i = 0 ; i < 300000 ; ++i )
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        const auto value = static_cast< double >( static_cast< std::int64_t >( state >> 20 ) % 200000 - 100000 ) * 0.01;
+        many_degrees.push_back( deg( value ) );
+        many_idegrees.push_back( ideg( static_cast< int >( value * 100.0 ) ) );
+        many_short.push_back( basic_angle< std::int16_t, deg_conv >( static_cast< std::int16_t >( value * 3.0 ) ) );
+        many_float.push_back( basic_angle< float, rad_conv >( static_cast< float >( value * 0.01 ) ) );
+    }
+
+    for( const auto order : { sort_key::value, sort_key::normalized } )
+    {
+        for( const auto threads : { 1u, 4u } )
+        {
+            assert_true( radix_sort_matches_stable_sort( many_degrees, order, threads ) );
+            assert_true( radix_sort_matches_stable_sort( many_idegrees, order, threads ) );
+            assert_true( radix_sort_matches_stable_sort( many_short, order, threads ) );
+            assert_true( radix_sort_matches_stable_sort( many_float, order, threads ) );
+        }
+    }
+    assert_true( radix_sort_matches_stable_sort( std::vector< deg >(), sort_key::value, 0 ) );
+}
+
+template< typename P >
+double twiddle_error( const twiddle_table & table )
+{
+    const auto n = static_cast< long double >( table.size() );
+
+    double error = 0.0;
+    for( std::size_t k = 0 ; k < table.size() ; ++k )
+    {
+        const auto x = 2.0L * 3.141592653589793238462643383279502884L * static_cast< long double >( k ) / n;
+        error = std::max( error, static_cast< double >( std::fabs( table.cos[ k ] - std::cos( x ) ) ) );
+        error = std::max( error, static_cast< double >( std::fabs( table.sin[ k ] - std::sin( x ) ) ) );
+    }
+    return error;
+}
+
+void twiddle_tables()
+{
+    for( const std::size_t n : { 1, 2, 3, 6, 8, 12, 360, 1000, 1024, 1031 } )
+    {
+        const auto table = make_twiddle_table( n );
+        assert_true( table.size() == n );
+        assert_true( twiddle_error< precise >( table ) < 2e-16 );
+        assert_true( twiddle_error< fast >( make_twiddle_table< fast >( n ) ) < fast::max_error );
+        assert_true( twiddle_error< fastest >( make_twiddle_table< fastest >( n ) ) < fastest::max_error );
+    }
+
+    // Exact symmetry
+    const auto table = make_twiddle_table( 64 );
+    assert_true( table.cos[ 0 ] == 1.0 && table.sin[ 0 ] == 0.0 );
+    assert_true( table.cos[ 16 ] == 0.0 && table.sin[ 16 ] == 1.0 );
+    assert_true( table.cos[ 32 ] == -1.0 && table.sin[ 32 ] == 0.0 );
+    assert_true( table.cos[ 48 ] == 0.0 && table.sin[ 48 ] == -1.0 );
+    bool symmetric = true;
+    for( std::size_t k = 1 ; k < 64 ; ++k )
+    {
+        symmetric = symmetric && table.cos[ k ] == table.cos[ 64 - k ] && table.sin[ k ] == -table.sin[ 64 - k ];
+        symmetric = symmetric && table.sin[ k ] == table.cos[ ( 80 - k ) % 64 ];
+    }
+    assert_true( symmetric );
+
+    // Cache
+    const auto cached = twiddles( 4096 );
+    assert_true( cached->size() == 4096 && twiddles( 4096 ) == cached );
+    assert_true( twiddles< fast >( 4096 ) != cached );
+
+    std::vector< std::shared_ptr< const twiddle_table > > concurrent( 4 );
+    std::vector< std::thread > threads;
+    for( std::size_t t = 0 ; t < concurrent.size() ; ++t )
+    {
+        threads.emplace_back( [ &concurrent, t ]() { concurrent[ t ] = twiddles( 2048 ); } );
+    }
+    for( auto & t : threads )
+    {
+        t.join();
+    }
+    assert_true( concurrent[ 0 ] == concurrent[ 1 ] && concurrent[ 0 ] == concurrent[ 3 ] );
+
+    clear_twiddle_cache();
+    assert_true( twiddles( 4096 ) != cached && cached->size() == 4096 );
+
+    // Compile time tables
+    static_assert( fixed_twiddles< 8 >::table.cos[ 2 ] == 0.0 && fixed_twiddles< 8 >::table.sin[ 6 ] == -1.0, "fixed twiddles" );
+    static_assert( fixed_twiddles< 8 >::table.cos[ 1 ] == fixed_twiddles< 8 >::table.sin[ 1 ], "fixed twiddles" );
+    bool same = true;
+    const auto & fixed = fixed_twiddles< 360 >::table;
+    const auto   table360 = make_twiddle_table( 360 );
+    for( std::size_t k = 0 ; k < 360 ; ++k )
+    {
+        same = same && std::fabs( fixed.cos[ k ] - table360.cos[ k ] ) < 2e-16 && std::fabs( fixed.sin[ k ] - table360.sin[ k ] ) < 2e-16;
+    }
+    assert_true( same );
+}
+
+void fixed_arrays()
+{
+    using namespace pg::math::trigonometric_literals;
+
+    const std::array< deg, 4 > wheels = { { 30_deg, -45_deg, 400_deg, 1e12_deg } };
+
+    std::array< double, 4 > s;
+    std::array< double, 4 > c;
+    sincos( wheels, s, c );
+    const auto s_fast = sin< fast >( wheels );
+    const auto c_fast = cos< fast >( wheels );
+    for( std::size_t i = 0 ; i < wheels.size() ; ++i )
+    {
+        assert_true( std::fabs( s[ i ] - pg::math::sin( wheels[ i ] ) ) < precise::max_error );
+        assert_true( std::fabs( c[ i ] - pg::math::cos( wheels[ i ] ) ) < precise::max_error );
+        assert_true( std::fabs( s_fast[ i ] - pg::math::sin( wheels[ i ] ) ) < fast::max_error );
+        assert_true( std::fabs( c_fast[ i ] - pg::math::cos( wheels[ i ] ) ) < fast::max_error );
+    }
+
+    std::array< ideg, 6 > joints = { { ideg( 270 ), ideg( -270 ), ideg( 720 ), ideg( -180 ), ideg( 181 ), ideg( 0 ) } };
+    const auto joints_abs = normalized_abs( joints );
+    assert_true( joints_abs[ 0 ].angle() == 270 && joints_abs[ 1 ].angle() == 90 && joints_abs[ 3 ].angle() == 180 );
+    normalize( joints );
+    assert_true( joints[ 0 ].angle() == -90 && joints[ 1 ].angle() == 90 && joints[ 2 ].angle() == 0 && joints[ 4 ].angle() == -179 );
+    normalize_abs( joints );
+    assert_true( joints[ 0 ].angle() == 270 && joints[ 4 ].angle() == 181 );
+
+    const auto phases = angle_cast< rad >( std::array< deg, 2 >{ { 180_deg, -90_deg } } );
+    assert_same( phases[ 0 ].angle(), pi );
+    assert_same( phases[ 1 ].angle(), -0.5 * pi );
+}
+
+void cordic()
+{
+    using bam = basic_angle< std::int16_t, bam16_conv >;
+
+    // The error of 24 iterations is about 2^-24, plus the rounding of the shifts
+    auto sincos_error = 0.0;
+    for( int i = -720 ; i <= 720 ; ++i )
+    {
+        std::int32_t s;
+        std::int32_t c;
+        cordic_sincos( ideg( i ), s, c );
+        const auto x = i * pi / 180.0;
+        sincos_error = std::max( sincos_error, std::fabs( s / double( cordic_unit ) - std::sin( x ) ) );
+        sincos_error = std::max( sincos_error, std::fabs( c / double( cordic_unit ) - std::cos( x ) ) );
+    }
+    assert_true( sincos_error < 1e-6 );
+    assert_true( cordic_sin( ideg( 90 ) ) == cordic_cos( ideg( 0 ) ) );
+    assert_true( cordic_sin( ideg( -30 ) ) == -cordic_sin( ideg( 30 ) ) );
+    assert_true( std::abs( cordic_cos( ideg( 60 ) ) - cordic_unit / 2 ) < 128 );
+    assert_true( std::abs( cordic_sin< 12 >( bam( -16384 ) ) + cordic_unit ) < ( cordic_unit >> 10 ) );
+
+    // Unsigned 64 bit angles from 2^63 on
+    assert_true( std::abs( cordic_sin( basic_angle< std::uint64_t, deg_conv >( ~std::uint64_t( 0 ) ) ) - cordic_sin( ideg( 15 ) ) ) <= 1 );
+
+    // Fewer iterations are less precise
+    assert_true( std::abs( cordic_sin< 8 >( ideg( 25 ) ) - cordic_sin( ideg( 25 ) ) ) > ( cordic_unit >> 16 ) );
+
+    auto atan2_exact = true;
+    auto magnitude_exact = true;
+    for( int y = -60 ; y <= 60 ; y += 7 )
+    {
+        for( int x = -60 ; x <= 60 ; x += 5 )
+        {
+            const auto a = std::atan2( double( y ), double( x ) );
+            atan2_exact = atan2_exact && std::abs( cordic_atan2< ideg >( y, x ).angle() - std::lround( a * 180.0 / pi ) ) <= 1;
+            atan2_exact = atan2_exact && std::abs( cordic_atan2< bam >( y * 1000, x * 1000 ).angle() - std::lround( a * 32768.0 / pi ) ) <= 1;
+            magnitude_exact = magnitude_exact && cordic_magnitude( x, y ) == static_cast< std::uint64_t >( std::lround( std::hypot( x, y ) ) );
+        }
+    }
+    assert_true( atan2_exact );
+    assert_true( magnitude_exact );
+    assert_true( cordic_atan2< ideg >( 0, 0 ).angle() == 0 );
+    assert_true( cordic_atan2< ideg >( 5, 0 ).angle() == 90 );
+    assert_true( cordic_atan2< ideg >( 0, -5 ).angle() == 180 );
+    assert_true( cordic_atan2< ideg >( 5, std::numeric_limits< int >::min() ).angle() == 180 );
+    assert_true( cordic_atan2< ideg >( -5, std::numeric_limits< int >::min() ).angle() == -180 );
+    assert_true( cordic_atan2< ideg >( -1, -5 ).angle() == -169 );
+    assert_true( cordic_magnitude( 2147483647, -2147483647 - 1 ) == static_cast< std::uint64_t >( std::llround( std::hypot( 2147483647.0, 2147483648.0 ) ) ) );
+
+    std::vector< ideg >         angles( 1000 );
+    std::vector< std::int32_t > s( angles.size() );
+    std::vector< std::int32_t > c( angles.size() );
+    for( std::size_t i = 0 ; i < angles.size() ; ++i )
+    {
+        angles[ i ] = ideg( static_cast< int >( i * 7919 % 2000 ) - 1000 );
+    }
+    cordic_sincos( angles.data(), angles.size(), s.data(), c.data() );
+
+    auto batch_same = true;
+    for( std::size_t i = 0 ; i < angles.size() ; ++i )
+    {
+        batch_same = batch_same && s[ i ] == cordic_sin( angles[ i ] ) && c[ i ] == cordic_cos( angles[ i ] );
+    }
+    assert_true( batch_same );
+
+    const int ys[ 3 ] = { 1, -1, 0 };
+    const int xs[ 3 ] = { 1, 1, -1 };
+    ideg      atans[ 3 ];
+    cordic_atan2( ys, xs, 3, atans );
+    assert_true( atans[ 0 ].angle() == 45 && atans[ 1 ].angle() == -45 && atans[ 2 ].angle() == 180 );
+}
+
+void quantized_arrays()
+{
+    using namespace pg::math::trigonometric_literals;
+
+    static_assert( sizeof( quantized_angles< deg >::storage_type ) == 2, "16 bit storage by default" );
+    assert_true( quantized_angles< deg >::resolution() == 360.0L / 65536.0L );
+    assert_true( ( quantized_angles< rad, std::uint32_t >::resolution() == 2.0L * static_cast< long double >( rad_conv::semicircle ) / 4294967296.0L ) );
+
+    quantized_angles< deg > bearings = { 0_deg, 90_deg, -90_deg, 725_deg, 359.999_deg, -0.001_deg };
+    assert_true( bearings.size() == 6 );
+    assert_true( bearings.data()[ 1 ] == 16384 && bearings.data()[ 2 ] == 49152 );
+    assert_true( bearings.data()[ 4 ] == 0 && bearings.data()[ 5 ] == 0 );
+    assert_same( bearings[ 2 ].angle(), 270.0 );
+    assert_true( std::fabs( bearings[ 3 ].angle() - 5.0 ) <= quantized_angles< deg >::resolution() / 2 );
+
+    // Integral angles round exactly
+    assert_true( ( quantized_angles< basic_angle< std::uint64_t, deg_conv > >::quantize( basic_angle< std::uint64_t, deg_conv >( ~std::uint64_t( 0 ) ) ) == 2731 ) );
+    assert_true( quantized_angles< ideg >::quantize( ideg( -90 ) ) == 49152 );
+    assert_true( quantized_angles< deg >::quantize( deg( 1e17 ) ) == 50972 );
+    assert_true( quantized_angles< deg >::quantize( deg( -1e17 ) ) == 14564 );
+    assert_true( ( quantized_angles< ideg, std::uint8_t >::quantize( ideg( -1 ) ) == 255 && quantized_angles< ideg, std::uint8_t >::quantize( ideg( 720 ) ) == 0 ) );
+    assert_true( ( quantized_angles< ideg, std::uint32_t >::quantize( ideg( 1 ) ) == 11930465 ) );
+
+    std::vector< deg > tracks( 1000 );
+    for( std::size_t i = 0 ; i < tracks.size() ; ++i )
+    {
+        tracks[ i ] = deg( static_cast< double >( i ) * 0.73 - 365.0 );
+    }
+    const quantized_angles< deg, std::uint32_t > compact( tracks.data(), tracks.size() );
+
+    std::vector< double > s( tracks.size() );
+    std::vector< double > c( tracks.size() );
+    std::vector< double > s_fast( tracks.size() );
+    sincos( compact, s.data(), c.data() );
+    sin< fast >( compact, s_fast.data() );
+
+    std::vector< deg > widened( tracks.size() );
+    std::vector< deg > widened_abs( tracks.size() );
+    std::vector< rad > radians( tracks.size() );
+    normalized( compact, widened.data() );
+    normalized_abs( compact, widened_abs.data() );
+    angle_cast< rad >( compact, radians.data() );
+
+    auto within = true;
+    for( std::size_t i = 0 ; i < tracks.size() ; ++i )
+    {
+        const auto x = tracks[ i ].angle() * pi / 180.0;
+        within = within && std::fabs( s[ i ] - std::sin( x ) ) < 1e-9 && std::fabs( c[ i ] - std::cos( x ) ) < 1e-9;
+        within = within && std::fabs( s_fast[ i ] - std::sin( x ) ) < fast::max_error + 1e-9;
+        within = within && std::fabs( widened[ i ].angle() - tracks[ i ].normalized().angle() ) < 1e-7;
+        within = within && std::fabs( widened_abs[ i ].angle() - tracks[ i ].normalized_abs().angle() ) < 1e-7;
+        within = within && std::fabs( radians[ i ].angle() - angle_cast< rad >( tracks[ i ].normalized_abs() ).angle() ) < 1e-9;
+    }
+    assert_true( within );
+
+    quantized_angles< deg > history;
+    history.push_back( 45_deg );
+    history.set( 0, 180_deg );
+    std::vector< double > cosines( 1 );
+    cos( history, cosines.data() );
+    assert_same( cosines[ 0 ], -1.0 );
+}
+
+void dual_numbers()
+{
+    // d/dx sin( x degrees ) = cos( x ) * pi / 180
+    const dual_deg theta( { 30.0, 1.0 } );
+    const auto s = sin( theta );
+    const auto c = cos( theta );
+    const auto t = tan( theta );
+    assert_same( s.value, 0.5 );
+    assert_same( s.derivative, std::cos( pi / 6 ) * pi / 180 );
+    assert_same( c.derivative, -0.5 * pi / 180 );
+    assert_same( t.derivative, pi / 180 / 0.75 );
+
+    // The values are the same as those of angle objects
+    assert_true( sin( dual_deg( { 180.0, 1.0 } ) ).value == static_cast< double >( sin( deg( 180.0 ) ) ) );
+    assert_true( cos( dual_grad( { 50.0, 1.0 } ) ).value == static_cast< double >( cos( grad( 50.0 ) ) ) );
+    assert_true( sin( dual_rad( { 2.5, 1.0 } ) ).value == static_cast< double >( sin( rad( 2.5 ) ) ) );
+
+    dual< double > s2;
+    dual< double > c2;
+    sincos( dual_rad( { 1.0, 2.0 } ), s2, c2 );
+    assert_same( s2.derivative, 2.0 * std::cos( 1.0 ) );
+    assert_same( c2.derivative, -2.0 * std::sin( 1.0 ) );
+
+    const auto s_fast = sin< fast >( dual_grad( { 50.0, 1.0 } ) );
+    assert_true( std::fabs( s_fast.value - std::sqrt( 0.5 ) ) < fast::max_error );
+    assert_true( std::fabs( s_fast.derivative - std::sqrt( 0.5 ) * pi / 200 ) < 1e-8 );
+
+    // The derivative is scaled with the unit
+    const auto r = angle_cast< dual_rad >( theta * 2 );
+    assert_same( r.angle().value, pi / 3 );
+    assert_same( r.angle().derivative, 2.0 * pi / 180 );
+
+    // The chain rule through arithmetic on the dual values
+    const auto x = dual< double >( 2.0, 1.0 );
+    const auto f = x * x / ( x + 1.0 ) - x;
+    assert_same( f.derivative, ( ( 2.0 * 2.0 * 3.0 - 4.0 ) / 9.0 - 1.0 ) );
+
+    // atan2 of a point moving along ( cos t, sin t ) at t = 1 radian turns with 180 / pi degrees per radian
+    const auto a = atan2< dual_deg >( dual< double >( std::sin( 1.0 ), std::cos( 1.0 ) ), dual< double >( std::cos( 1.0 ), -std::sin( 1.0 ) ) );
+    assert_true( std::fabs( a.angle().value - 180.0 / pi ) < 1e-12 );
+    assert_true( std::fabs( a.angle().derivative - 180.0 / pi ) < 1e-12 );
+    assert_true( std::fabs( atan2( dual< double >( 1.0, 0.0 ), dual< double >( 0.0, 1.0 ) ).angle().derivative + 1.0 ) < 1e-15 );
+
+    std::vector< deg >    joints( 100 );
+    std::vector< double > js( joints.size() );
+    std::vector< double > jc( joints.size() );
+    std::vector< double > jds( joints.size() );
+    std::vector< double > jdc( joints.size() );
+    for( std::size_t i = 0 ; i < joints.size() ; ++i )
+    {
+        joints[ i ] = deg( static_cast< double >( i ) * 7.5 - 360.0 );
+    }
+    sincos_jacobian( joints.data(), joints.size(), js.data(), jc.data(), jds.data(), jdc.data() );
+
+    std::vector< dual_deg >       dual_joints( joints.size() );
+    std::vector< dual< double > > ds( joints.size() );
+    std::vector< dual< double > > dc( joints.size() );
+    for( std::size_t i = 0 ; i < joints.size() ; ++i )
+    {
+        dual_joints[ i ] = dual_deg( { joints[ i ].angle(), 1.0 } );
+    }
+    sincos( dual_joints.data(), dual_joints.size(), ds.data(), dc.data() );
+
+    auto jacobian_same = true;
+    for( std::size_t i = 0 ; i < joints.size() ; ++i )
+    {
+        const auto h  = 1e-6;
+        const auto fd = ( std::sin( ( joints[ i ].angle() + h ) * pi / 180 ) - std::sin( ( joints[ i ].angle() - h ) * pi / 180 ) ) / ( 2 * h );
+        jacobian_same = jacobian_same && std::fabs( jds[ i ] - fd ) < 1e-9 && std::fabs( ds[ i ].derivative - fd ) < 1e-9;
+        jacobian_same = jacobian_same && std::fabs( jdc[ i ] + js[ i ] * pi / 180 ) < 1e-15 && std::fabs( dc[ i ].value - jc[ i ] ) < 1e-14;
+    }
+    assert_true( jacobian_same );
+}
+
+void sincos_memo()
+{
+    using namespace pg::math::trigonometric_literals;
+
+    clear_sincos_cache< deg >();
+    clear_sincos_cache< deg, fast >();
+
+    double s;
+    double c;
+    cached_sincos( 30_deg, s, c );
+    assert_true( s == static_cast< double >( pg::math::sin( 30_deg ) ) && c == static_cast< double >( pg::math::cos( 30_deg ) ) );
+    assert_true( cached_sin( 30_deg ) == pg::math::sin( 30_deg ) );
+    assert_true( cached_cos( 30_deg ) == pg::math::cos( 30_deg ) );
+    assert_true( sincos_cache_stats< deg >().hits == 2 && sincos_cache_stats< deg >().misses == 1 );
+
+    // The policies and the signs of zero have their own entries
+    assert_true( ( cached_sin< fast >( 30_deg ) == pg::math::sin< fast >( 30_deg ) ) );
+    assert_true( ( sincos_cache_stats< deg, fast >().misses == 1 ) );
+    assert_true( std::signbit( cached_sin( deg( -0.0 ) ) ) && !std::signbit( cached_sin( deg( 0.0 ) ) ) );
+
+    // Quantized headings repeat
+    std::vector< deg > headings( 20000 );
+    for( std::size_t i = 0 ; i < headings.size() ; ++i )
+    {
+        headings[ i ] = deg( static_cast< double >( i * 7919 % 3600 ) * 0.1 );
+    }
+    std::vector< double > sines( headings.size() );
+    std::vector< double > cosines( headings.size() );
+    clear_sincos_cache< deg, fast >();
+    cached_sincos< fast >( headings.data(), headings.size(), sines.data(), cosines.data() );
+
+    auto same = true;
+    for( std::size_t i = 0 ; i < headings.size() ; ++i )
+    {
+        same = same && sines[ i ] == pg::math::sin< fast >( headings[ i ] ) && cosines[ i ] == pg::math::cos< fast >( headings[ i ] );
+    }
+    assert_true( same );
+
+    const auto stats = sincos_cache_stats< deg, fast >();
+    assert_true( stats.hits + stats.misses == headings.size() );
+    assert_true( stats.hits > headings.size() / 2 );
+
+    // Each thread has its own cache
+    sincos_cache_statistics other = { 1, 1 };
+    std::thread worker( [ & ]() { other = sincos_cache_stats< deg, fast >(); } );
+    worker.join();
+    assert_true( other.hits == 0 && other.misses == 0 );
+
+    clear_sincos_cache< deg, fast >();
+    assert_true( ( sincos_cache_stats< deg, fast >().hits == 0 ) );
+}
+
+void harmonic_series()
+{
+    using namespace pg::math::trigonometric_literals;
+
+    constexpr std::size_t K = 64;
+
+    // The errors of the recurrence grow linearly with the harmonic
+    auto recurrence_error = 0.0;
+    for( const auto a : { 0.001_deg, 1_deg, 37.5_deg, 90_deg, 179.999_deg, -123.4_deg, 1000_deg } )
+    {
+        double s[ K ];
+        double c[ K ];
+        harmonics( a, K, s, c );
+        for( std::size_t k = 0 ; k < K ; ++k )
+        {
+            const auto x = std::fmod( static_cast< double >( k + 1 ) * a.angle(), 360.0 ) * pi / 180.0;
+            recurrence_error = std::max( recurrence_error, std::max( std::fabs( s[ k ] - std::sin( x ) ), std::fabs( c[ k ] - std::cos( x ) ) ) );
+        }
+    }
+    assert_true( recurrence_error < 1e-13 );
+
+    double s_fast[ 3 ];
+    double c_fast[ 3 ];
+    harmonics< fast >( 30_deg, 3, s_fast, c_fast );
+    assert_true( std::fabs( s_fast[ 2 ] - 1.0 ) < 4 * fast::max_error && std::fabs( c_fast[ 1 ] - 0.5 ) < 4 * fast::max_error );
+
+    // Square wave of 4 / pi * sum of sin( k x ) / k for odd k
+    std::vector< double > a( K, 0.0 );
+    std::vector< double > b( K, 0.0 );
+    for( std::size_t k = 1 ; k <= K ; k += 2 )
+    {
+        b[ k - 1 ] = 4.0 / ( pi * static_cast< double >( k ) );
+    }
+    a[ 1 ] = 0.25;
+    assert_true( std::fabs( fourier_series( 90_deg, a.data(), b.data(), K ) - ( 1.0 - 0.25 ) ) < 0.02 );
+
+    std::vector< rad > samples( 37 );
+    for( std::size_t i = 0 ; i < samples.size() ; ++i )
+    {
+        samples[ i ] = rad( static_cast< double >( i ) * 0.3 - 5.0 );
+    }
+    std::vector< double > sums( samples.size() );
+    fourier_series( samples.data(), samples.size(), a.data(), b.data(), K, sums.data() );
+
+    std::vector< double > rows_s( samples.size() * K );
+    std::vector< double > rows_c( samples.size() * K );
+    harmonics( samples.data(), samples.size(), K, rows_s.data(), rows_c.data() );
+
+    auto batch_same = true;
+    for( std::size_t i = 0 ; i < samples.size() ; ++i )
+    {
+        auto direct = 0.0;
+        for( std::size_t k = 0 ; k < K ; ++k )
+        {
+            const auto x = static_cast< double >( k + 1 ) * samples[ i ].angle();
+            direct += a[ k ] * std::cos( x ) + b[ k ] * std::sin( x );
+            batch_same = batch_same && std::fabs( rows_s[ i * K + k ] - std::sin( x ) ) < 1e-13;
+        }
+        batch_same = batch_same && std::fabs( sums[ i ] - direct ) < 1e-12;
+        batch_same = batch_same && std::fabs( sums[ i ] - fourier_series( samples[ i ], a.data(), b.data(), K ) ) < 1e-12;
+    }
+    assert_true( batch_same );
+}
+
 void formatting()
 {
     using namespace pg::math::trigonometric_literals;
@@ -517,6 +1997,59 @@ void algorithms()
 #endif
 }
 
+void instrumentation_counters()
+{
+    namespace ins = pg::math::instrumentation;
+
+    const auto record_calls = []
+    {
+        ins::detail::record( ins::probe::sin, deg( 90 ) );
+        ins::detail::record( ins::probe::sin, deg( 1000 ) );
+        ins::detail::record( ins::probe::sin, rad( 1e9 ) );
+        ins::detail::record( ins::probe::normalize, ideg( -270 ) );
+    };
+
+    record_calls();
+    std::thread worker( record_calls );
+    worker.join();
+
+    const auto entries = ins::take_snapshot();
+    assert_true( entries.size() == 3 );
+
+    std::uint64_t total = 0;
+    for( const auto & entry : entries )
+    {
+        total += entry.calls;
+        if( entry.function == ins::probe::sin && entry.angle_type == "f64@180" )
+        {
+            assert_true( entry.calls == 4 );
+            assert_true( entry.histogram[ 0 ] == 2 );
+            assert_true( entry.histogram[ 2 ] == 2 );
+        }
+        else if( entry.function == ins::probe::sin )
+        {
+            assert_true( entry.angle_type.compare( 0, 4, "f64@" ) == 0 );
+            assert_true( entry.histogram[ 5 ] == 2 );
+        }
+        else
+        {
+            assert_true( entry.function == ins::probe::normalize );
+            assert_true( entry.angle_type == "i32@180" );
+            assert_true( entry.histogram[ 1 ] == 2 );
+        }
+    }
+    assert_true( total == 8 );
+
+    std::stringstream text;
+    ins::write_text( text, entries );
+    assert_true( text.str().find( "sin f64@180 calls=4 <=1=2 <=2=0 <=2^8=2" ) != std::string::npos );
+
+    std::stringstream json;
+    ins::write_json( json, entries );
+    assert_true( json.str().front() == '[' && json.str().back() == ']' );
+    assert_true( json.str().find( "{\"function\":\"normalize\",\"angle_type\":\"i32@180\",\"calls\":2," ) != std::string::npos );
+}
+
 struct conversion
 {
     constexpr static int semicircle = 128;
@@ -624,6 +2157,7 @@ int main( const int /* argc */, const char ** /* argv[] */ )
     literals();
     angle_cast();
     normalize();
+    integer_normalize();
     angle_ceil();
     angle_floor();
     angle_round();
@@ -634,9 +2168,28 @@ int main( const int /* argc */, const char ** /* argv[] */ )
     tan();
     atan();
     atan2();
+    batch_inverse();
+    precision_policies();
+    unwrapped();
+    rotation();
+    geodesy();
+    bearing_destination();
+    native_coefficients();
+    pipeline();
+    interval_set();
+    circular_nearest();
+    radix_sort_angles();
+    twiddle_tables();
+    fixed_arrays();
+    cordic();
+    quantized_arrays();
+    dual_numbers();
+    sincos_memo();
+    harmonic_series();
     formatting();
     adl();
     algorithms();
+    instrumentation_counters();
     readme_examples();
 
     std::cout << "Total tests: " << total_checks << ", Tests failed: " << failed_checks << '\n';
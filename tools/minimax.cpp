@@ -0,0 +1,407 @@
+// See LICENSE for the Copyright Notice
+
+// Generates a header with minimax polynomials of sine, cosine and arc tangent for an angle unit.
+//
+// Usage: minimax <name> <semicircle> <precision> <sin degree> <cos degree> <atan degree>
+//
+// The header contains a struct <name> that is attached to a conversion object with
+// 'using coefficients = <name>;'. The kernels of the given precision policy then evaluate the
+// polynomials on the angle in its own unit without converting it to radians first.
+// The degrees are the degrees of the polynomials in the angle; sine and arc tangent use the odd
+// powers and cosine the even powers. The achieved maximum absolute errors are written to the
+// header and to stderr. When an error exceeds the bound of the policy or a fit fails, nothing is
+// written to stdout and the exit status is 1.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using real = long double;
+
+constexpr real pi = 3.141592653589793238462643383279502884L;
+
+// Solves A x = b with Gaussian elimination and partial pivoting
+std::vector< real > solve( std::vector< std::vector< real > > a, std::vector< real > b )
+{
+    const auto n = b.size();
+    for( std::size_t i = 0 ; i < n ; ++i )
+    {
+        auto pivot = i;
+        for( auto r = i + 1 ; r < n ; ++r )
+        {
+            if( std::fabs( a[ r ][ i ] ) > std::fabs( a[ pivot ][ i ] ) )
+            {
+                pivot = r;
+            }
+        }
+        std::swap( a[ i ], a[ pivot ] );
+        std::swap( b[ i ], b[ pivot ] );
+
+        for( auto r = i + 1 ; r < n ; ++r )
+        {
+            const auto f = a[ r ][ i ] / a[ i ][ i ];
+            for( auto c = i ; c < n ; ++c )
+            {
+                a[ r ][ c ] -= f * a[ i ][ c ];
+            }
+            b[ r ] -= f * b[ i ];
+        }
+    }
+
+    std::vector< real > x( n );
+    for( auto i = n ; i-- > 0 ; )
+    {
+        auto s = b[ i ];
+        for( auto c = i + 1 ; c < n ; ++c )
+        {
+            s -= a[ i ][ c ] * x[ c ];
+        }
+        x[ i ] = s / a[ i ][ i ];
+    }
+
+    return x;
+}
+
+real chebyshev( const std::vector< real > & coefficients, real u )
+{
+    real t0  = 1.0L;
+    real t1  = u;
+    real sum = coefficients[ 0 ];
+    for( std::size_t k = 1 ; k < coefficients.size() ; ++k )
+    {
+        sum += coefficients[ k ] * t1;
+        const auto t2 = 2.0L * u * t1 - t0;
+        t0 = t1;
+        t1 = t2;
+    }
+    return sum;
+}
+
+// Finds the monomial coefficients of the polynomial of the given degree in z on [0, b] that
+// minimizes the maximum absolute error to f with the Remez exchange algorithm.
+// Returns no coefficients when the exchange loses the alternation of the error.
+std::vector< real > remez( const std::function< real( real ) > & f, real b, int degree )
+{
+    const auto m = static_cast< std::size_t >( degree + 2 );
+    const auto z = [ b ]( real u ) { return b / 2.0L * ( u + 1.0L ); };
+
+    std::vector< real > reference( m );
+    for( std::size_t i = 0 ; i < m ; ++i )
+    {
+        reference[ i ] = -std::cos( pi * i / ( m - 1 ) );
+    }
+
+    std::vector< real > coefficients;
+    for( int iteration = 0 ; iteration < 100 ; ++iteration )
+    {
+        // Solve for the Chebyshev coefficients and the levelled error
+        std::vector< std::vector< real > > a( m, std::vector< real >( m ) );
+        std::vector< real > y( m );
+        for( std::size_t i = 0 ; i < m ; ++i )
+        {
+            real t0 = 1.0L;
+            real t1 = reference[ i ];
+            a[ i ][ 0 ] = 1.0L;
+            for( std::size_t k = 1 ; k + 1 < m ; ++k )
+            {
+                a[ i ][ k ] = t1;
+                const auto t2 = 2.0L * reference[ i ] * t1 - t0;
+                t0 = t1;
+                t1 = t2;
+            }
+            a[ i ][ m - 1 ] = i % 2 ? -1.0L : 1.0L;
+            y[ i ] = f( z( reference[ i ] ) );
+        }
+
+        const auto x     = solve( a, y );
+        const auto level = std::fabs( x[ m - 1 ] );
+        coefficients.assign( x.begin(), x.end() - 1 );
+
+        // The new reference is the extremum of each interval where the error has the same sign
+        const auto error = [ & ]( real u ) { return f( z( u ) ) - chebyshev( coefficients, u ); };
+        const int  grid  = 20000;
+        const auto at    = []( int j ) { return -std::cos( pi * j / grid ); };
+
+        std::vector< real > points;
+        std::vector< real > extrema;
+        int i = 0;
+        while( i <= grid )
+        {
+            const bool positive = error( at( i ) ) >= 0.0L;
+            auto       best     = i;
+            for( ; i <= grid && ( error( at( i ) ) >= 0.0L ) == positive ; ++i )
+            {
+                best = std::fabs( error( at( i ) ) ) > std::fabs( error( at( best ) ) ) ? i : best;
+            }
+
+            auto lo = at( std::max( best - 1, 0 ) );
+            auto hi = at( std::min( best + 1, grid ) );
+            for( int r = 0 ; r < 60 ; ++r )
+            {
+                const auto m1 = lo + ( hi - lo ) / 3.0L;
+                const auto m2 = hi - ( hi - lo ) / 3.0L;
+                if( std::fabs( error( m1 ) ) < std::fabs( error( m2 ) ) )
+                {
+                    lo = m1;
+                }
+                else
+                {
+                    hi = m2;
+                }
+            }
+            const auto refined = ( lo + hi ) / 2.0L;
+            const auto point   = std::fabs( error( refined ) ) > std::fabs( error( at( best ) ) ) ? refined : at( best );
+            points.push_back( point );
+            extrema.push_back( std::fabs( error( point ) ) );
+        }
+
+        // Drop the smallest extrema while keeping the signs alternating
+        while( points.size() > m )
+        {
+            const auto k = static_cast< std::size_t >( std::min_element( extrema.begin(), extrema.end() ) - extrema.begin() );
+            if( k == 0 || k + 1 == points.size() )
+            {
+                points.erase( points.begin() + k );
+                extrema.erase( extrema.begin() + k );
+                continue;
+            }
+
+            const auto first = extrema[ k - 1 ] < extrema[ k + 1 ] ? k - 1 : k;
+            points.erase( points.begin() + first, points.begin() + first + 2 );
+            extrema.erase( extrema.begin() + first, extrema.begin() + first + 2 );
+        }
+
+        if( points.size() < m )
+        {
+            std::fprintf( stderr, "minimax: lost the alternation after %d iterations\n", iteration );
+            return {};
+        }
+
+        reference = points;
+        const auto maximum = *std::max_element( extrema.begin(), extrema.end() );
+        if( maximum - level < 1e-4L * maximum )
+        {
+            break;
+        }
+    }
+
+    // Convert the Chebyshev series in u = 2 z / b - 1 to monomials in z
+    const auto alpha = 2.0L / b;
+    const auto beta  = -1.0L;
+    std::vector< real > monomials( coefficients.size(), 0.0L );
+    std::vector< real > previous = { 1.0L };
+    std::vector< real > current  = { beta, alpha };
+    monomials[ 0 ] += coefficients[ 0 ];
+    if( coefficients.size() > 1 )
+    {
+        monomials[ 0 ] += coefficients[ 1 ] * beta;
+        monomials[ 1 ] += coefficients[ 1 ] * alpha;
+    }
+    for( std::size_t k = 2 ; k < coefficients.size() ; ++k )
+    {
+        std::vector< real > next( k + 1, 0.0L );
+        for( std::size_t j = 0 ; j < current.size() ; ++j )
+        {
+            next[ j ]     += 2.0L * beta * current[ j ];
+            next[ j + 1 ] += 2.0L * alpha * current[ j ];
+        }
+        for( std::size_t j = 0 ; j < previous.size() ; ++j )
+        {
+            next[ j ] -= previous[ j ];
+        }
+        for( std::size_t j = 0 ; j <= k ; ++j )
+        {
+            monomials[ j ] += coefficients[ k ] * next[ j ];
+        }
+        previous = current;
+        current  = next;
+    }
+
+    return monomials;
+}
+
+double horner( const std::vector< double > & coefficients, double z )
+{
+    auto result = coefficients.back();
+    for( auto i = coefficients.size() - 1 ; i > 0 ; --i )
+    {
+        result = result * z + coefficients[ i - 1 ];
+    }
+    return result;
+}
+
+struct polynomial
+{
+    std::vector< double > coefficients;
+    double                error;
+};
+
+// A fit that failed has an infinite error
+const polynomial failed = { {}, HUGE_VAL };
+
+// Fits sin( t ) / t on |t| <= pi / 4 and scales the coefficients to the angle x in the unit
+polynomial fit_sin( real semicircle, int degree )
+{
+    const auto radians = remez( []( real z ) { return z == 0.0L ? 1.0L : std::sin( std::sqrt( z ) ) / std::sqrt( z ); }, pi * pi / 16.0L, ( degree - 1 ) / 2 );
+    const auto a       = pi / semicircle;
+    if( radians.empty() )
+    {
+        return failed;
+    }
+
+    polynomial p = { {}, 0.0 };
+    for( std::size_t k = 0 ; k < radians.size() ; ++k )
+    {
+        p.coefficients.push_back( static_cast< double >( radians[ k ] * std::pow( a, static_cast< real >( 2 * k + 1 ) ) ) );
+    }
+    for( int i = 0 ; i <= 1000000 ; ++i )
+    {
+        const auto x = static_cast< double >( semicircle / 4.0L * i / 1000000 );
+        const auto e = std::fabs( x * horner( p.coefficients, x * x ) - std::sin( x * a ) );
+        p.error = std::max( p.error, static_cast< double >( e ) );
+    }
+    return p;
+}
+
+// Fits cos( t ) on |t| <= pi / 4 and scales the coefficients to the angle x in the unit
+polynomial fit_cos( real semicircle, int degree )
+{
+    const auto radians = remez( []( real z ) { return std::cos( std::sqrt( z ) ); }, pi * pi / 16.0L, degree / 2 );
+    const auto a       = pi / semicircle;
+    if( radians.empty() )
+    {
+        return failed;
+    }
+
+    polynomial p = { {}, 0.0 };
+    for( std::size_t k = 0 ; k < radians.size() ; ++k )
+    {
+        p.coefficients.push_back( static_cast< double >( radians[ k ] * std::pow( a, static_cast< real >( 2 * k ) ) ) );
+    }
+    for( int i = 0 ; i <= 1000000 ; ++i )
+    {
+        const auto x = static_cast< double >( semicircle / 4.0L * i / 1000000 );
+        const auto e = std::fabs( horner( p.coefficients, x * x ) - std::cos( x * a ) );
+        p.error = std::max( p.error, static_cast< double >( e ) );
+    }
+    return p;
+}
+
+// Fits atan( t ) / t on |t| <= tan( pi / 8 ) and scales the coefficients to a result in the unit;
+// the error is expressed in radians
+polynomial fit_atan( real semicircle, int degree )
+{
+    const auto b       = std::tan( pi / 8.0L );
+    const auto radians = remez( []( real z ) { return z == 0.0L ? 1.0L : std::atan( std::sqrt( z ) ) / std::sqrt( z ); }, b * b, ( degree - 1 ) / 2 );
+    const auto scale   = semicircle / pi;
+    if( radians.empty() )
+    {
+        return failed;
+    }
+
+    polynomial p = { {}, 0.0 };
+    for( std::size_t k = 0 ; k < radians.size() ; ++k )
+    {
+        p.coefficients.push_back( static_cast< double >( radians[ k ] * scale ) );
+    }
+    for( int i = 0 ; i <= 1000000 ; ++i )
+    {
+        const auto t = static_cast< double >( b * i / 1000000 );
+        const auto e = std::fabs( t * horner( p.coefficients, t * t ) - std::atan( static_cast< real >( t ) ) * scale ) / scale;
+        p.error = std::max( p.error, static_cast< double >( e ) );
+    }
+    return p;
+}
+
+void write_function( const char * function, const char * description, const polynomial & p )
+{
+    std::printf( "    // %s\n", description );
+    std::printf( "    static double %s( double z ) noexcept\n", function );
+    std::printf( "    {\n" );
+    std::printf( "        constexpr static double coefficients[] =\n" );
+    std::printf( "        {\n" );
+    for( std::size_t k = 0 ; k < p.coefficients.size() ; ++k )
+    {
+        std::printf( "            % .17e%s\n", p.coefficients[ k ], k + 1 < p.coefficients.size() ? "," : "" );
+    }
+    std::printf( "        };\n" );
+    std::printf( "        return pg::math::detail::trig::polynomial( coefficients, z );\n" );
+    std::printf( "    }\n" );
+}
+
+double max_error( const std::string & precision )
+{
+    return precision == "precise" ? 1e-15 : precision == "fast" ? 1e-7 : 1e-4;
+}
+
+}
+
+int main( const int argc, const char ** argv )
+{
+    if( argc != 7 )
+    {
+        std::fprintf( stderr, "usage: minimax <name> <semicircle> <precision> <sin degree> <cos degree> <atan degree>\n" );
+        return 1;
+    }
+
+    const std::string name       = argv[ 1 ];
+    const auto        semicircle = std::strtold( argv[ 2 ], nullptr );
+    const std::string precision  = argv[ 3 ];
+    const int         degrees[]  = { std::atoi( argv[ 4 ] ), std::atoi( argv[ 5 ] ), std::atoi( argv[ 6 ] ) };
+
+    if( !( semicircle > 0.0L ) || ( precision != "precise" && precision != "fast" && precision != "fastest" ) ||
+        degrees[ 0 ] < 1 || degrees[ 1 ] < 0 || degrees[ 2 ] < 1 )
+    {
+        std::fprintf( stderr, "minimax: invalid arguments\n" );
+        return 1;
+    }
+
+    const auto sin  = fit_sin( semicircle, degrees[ 0 ] );
+    const auto cos  = fit_cos( semicircle, degrees[ 1 ] );
+    const auto atan = fit_atan( semicircle, degrees[ 2 ] );
+
+    // Nothing is written when a polynomial does not meet the bound of the policy, so a bad fit cannot replace a header
+    std::fprintf( stderr, "%s: sin error %.3g, cos error %.3g, atan error %.3g radians\n", name.c_str(), sin.error, cos.error, atan.error );
+    if( !( std::max( { sin.error, cos.error, atan.error } ) <= max_error( precision ) ) )
+    {
+        std::fprintf( stderr, "minimax: the error exceeds the %g of the %s policy; change the degrees\n", max_error( precision ), precision.c_str() );
+        return 1;
+    }
+
+    std::printf( "// Generated by tools/minimax.cpp: minimax %s %s %s %s %s %s\n", argv[ 1 ], argv[ 2 ], argv[ 3 ], argv[ 4 ], argv[ 5 ], argv[ 6 ] );
+    std::printf( "\n" );
+    std::printf( "#pragma once\n" );
+    std::printf( "\n" );
+    std::printf( "#include <trigonometry.h>\n" );
+    std::printf( "\n" );
+    std::printf( "/**\n" );
+    std::printf( " * \\brief Minimax polynomials of the %s policy for a unit with a semicircle of %Lg.\n", precision.c_str(), semicircle );
+    std::printf( " *\n" );
+    std::printf( " * Maximum absolute errors: sin %.3g, cos %.3g, atan %.3g radians.\n", sin.error, cos.error, atan.error );
+    std::printf( " */\n" );
+    std::printf( "struct %s\n", name.c_str() );
+    std::printf( "{\n" );
+    std::printf( "    using precision = pg::math::%s;\n", precision.c_str() );
+    std::printf( "\n" );
+    std::printf( "    constexpr static long double semicircle = %.21LgL;\n", semicircle );
+    std::printf( "\n" );
+    std::printf( "    constexpr static double sin_error  = %.3e;\n", sin.error );
+    std::printf( "    constexpr static double cos_error  = %.3e;\n", cos.error );
+    std::printf( "    constexpr static double atan_error = %.3e;\n", atan.error );
+    std::printf( "\n" );
+    write_function( "sin", "sin( x ) / x with x in the unit as a polynomial of z = x^2 for |x| <= semicircle / 4", sin );
+    std::printf( "\n" );
+    write_function( "cos", "cos( x ) with x in the unit as a polynomial of z = x^2 for |x| <= semicircle / 4", cos );
+    std::printf( "\n" );
+    write_function( "atan", "atan( t ) / t in the unit as a polynomial of z = t^2 for |t| <= tan( pi / 8 )", atan );
+    std::printf( "};\n" );
+
+    return 0;
+}